@@ -15,6 +15,7 @@ log_warning() { echo -e "${YELLOW}[WARNING]${NC} $1"; }
 # Parse arguments
 BUILD_TYPE="Debug"
 DEPLOYMENT_MODE=false
+COLOR_DEPTH_16=false
 
 while [[ $# -gt 0 ]]; do
     case $1 in
@@ -28,6 +29,10 @@ while [[ $# -gt 0 ]]; do
             BUILD_TYPE="Debug"
             shift
             ;;
+        --rgb565)
+            COLOR_DEPTH_16=true
+            shift
+            ;;
         --help|-h)
             echo "LVGL Dashboard Build Script with HiFiBerry BeoCreate 4"
             echo "Usage: $0 [options]"
@@ -35,6 +40,7 @@ while [[ $# -gt 0 ]]; do
             echo "Options:"
             echo "  --dev, --debug      Debug build (windowed, default)"
             echo "  --deployment, --prod Release build (fullscreen)"
+            echo "  --rgb565            Render in 16-bit colour"
             echo "  --help, -h          Show this help"
             echo ""
             exit 0
@@ -154,6 +160,12 @@ else
     CMAKE_ARGS="$CMAKE_ARGS -DDEPLOYMENT_BUILD=OFF"
 fi
 
+if [ "$COLOR_DEPTH_16" = true ]; then
+    CMAKE_ARGS="$CMAKE_ARGS -DCOLOR_DEPTH_16=ON"
+else
+    CMAKE_ARGS="$CMAKE_ARGS -DCOLOR_DEPTH_16=OFF"
+fi
+
 log_info "Running CMake..."
 cmake $CMAKE_ARGS ..
 
@@ -0,0 +1,69 @@
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <lvgl.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Stub descriptors written by tools/pack_ui_assets.py --stubs carry this
+// flag and the image name in place of pixel data
+#define ASSET_PACK_IMAGE_FLAG LV_IMAGE_FLAGS_USER1
+
+struct AssetImage {
+    std::string name;
+    lv_image_header_t header;
+    const uint8_t* data = nullptr;   // Inside the mapping
+    uint32_t size = 0;
+};
+
+// UI images from one read-only mapped file (ASSET_PACK build).
+//
+// The pack is mapped without populating it and with readahead off, so an
+// image's pages come off the SD card the first time LVGL draws it and stay
+// in the page cache after that - shared, clean memory the kernel can drop
+// and re-read instead of 1.3 MB of .rodata in the binary. The decoder
+// resolves the stub descriptors ui/screens.c links against by name and
+// hands LVGL a pointer into the mapping; nothing is copied or decoded.
+class AssetPack {
+public:
+    AssetPack() = default;
+    ~AssetPack();
+
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    // Maps and validates the pack; false leaves the images blank
+    // (registerDecoder() is still needed so the stubs are never drawn raw)
+    bool open(const std::string& path);
+    void close();
+
+    const AssetImage* findImage(const char* name) const;
+    size_t imageCount() const { return images.size(); }
+
+    // Puts the pack decoder ahead of LVGL's built-in ones
+    void registerDecoder();
+
+    // $TAZZARI_ASSET_PACK, else tazzari.assets next to the executable
+    static std::string defaultPath();
+
+private:
+    static lv_result_t decoderInfo(lv_image_decoder_t* decoder, const void* src, lv_image_header_t* header);
+    static lv_result_t decoderOpen(lv_image_decoder_t* decoder, lv_image_decoder_dsc_t* dsc,
+                                   const lv_image_decoder_args_t* args);
+    static void decoderClose(lv_image_decoder_t* decoder, lv_image_decoder_dsc_t* dsc);
+
+    static bool isStub(const void* src);
+    const AssetImage* imageForSource(const void* src) const;
+    static void reportMissing(const void* src);
+
+    static AssetPack* registered;
+
+    std::vector<AssetImage> images;      // Sorted by name
+    lv_image_decoder_t* decoder = nullptr;
+    const uint8_t* map_base = nullptr;
+    size_t map_size = 0;
+};
+
+#endif // ASSET_PACK_H
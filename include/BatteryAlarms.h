@@ -0,0 +1,121 @@
+#ifndef BATTERY_ALARMS_H
+#define BATTERY_ALARMS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+enum AlarmSeverity {
+    ALARM_NONE = 0,
+    ALARM_INFO,
+    ALARM_WARNING,
+    ALARM_CRITICAL,
+};
+
+enum AlarmSignal {
+    SIGNAL_CELL_MAX_V = 0,
+    SIGNAL_CELL_MIN_V,
+    SIGNAL_TEMP_MAX,
+    SIGNAL_TEMP_MIN,
+    SIGNAL_SOC,
+    SIGNAL_CURRENT,          // A, negative while discharging
+    SIGNAL_CELL_SPREAD_MV,   // Only with per-cell frames
+    SIGNAL_COUNT
+};
+
+// Latest value of every signal; a signal only takes part once it has been set
+struct BatterySignals {
+    float value[SIGNAL_COUNT] = {};
+    bool present[SIGNAL_COUNT] = {};
+
+    void set(AlarmSignal signal, float v) {
+        value[signal] = v;
+        present[signal] = true;
+    }
+};
+
+struct AlarmRule {
+    AlarmSignal signal;
+    AlarmSeverity severity;
+    bool above;              // Raised above `set`, else below it
+    float set;
+    float clear;             // Hysteresis: cleared once back past this
+    uint32_t debounce_ms;    // Condition has to hold this long to raise or clear
+};
+
+struct AlarmEvent {
+    time_t time;
+    size_t rule;             // Index into getRules()
+    bool raised;             // false = cleared
+    float value;
+};
+
+// Battery alarm rules with hysteresis and debounce.
+//
+// Thresholds come from a text file with one section per chemistry:
+//
+//   chemistry = winston
+//   [winston]
+//   # signal      severity  op  set   clear  debounce_ms
+//   cell_max_v    warning   >   4.00  3.90   2000
+//
+// The built-in defaults are config/battery_alarms.conf, embedded at build
+// time, and go through the same parser. A rule is raised when its signal
+// crosses `set` and stays there for the debounce time, and cleared only
+// once it is back past `clear` for as long, so a value sitting on a
+// threshold doesn't toggle the icon. evaluate() runs
+// per BMS frame and only reports when an alarm changes state.
+class BatteryAlarms {
+public:
+    static constexpr size_t HISTORY_SIZE = 64;
+
+    BatteryAlarms();
+
+    // Load rules for the chemistry named in the file; on failure the
+    // current rules are kept
+    bool loadFile(const std::string& path);
+    bool loadText(const std::string& text, const std::string& origin);
+
+    // Path from TAZZARI_ALARM_CONFIG, else battery_alarms.conf in the data directory
+    static std::string defaultConfigPath();
+
+    // Returns true if any alarm was raised or cleared
+    bool evaluate(const BatterySignals& signals, uint32_t now_ms);
+
+    // Drop all active alarms (BMS link lost)
+    void reset();
+
+    AlarmSeverity getSeverity() const { return severity; }
+    bool isActive(size_t rule) const { return states[rule].active; }
+    const std::vector<AlarmRule>& getRules() const { return rules; }
+    const std::string& getChemistry() const { return chemistry; }
+
+    // Oldest first
+    size_t getHistoryCount() const { return history_count; }
+    const AlarmEvent& getHistory(size_t index) const;
+
+    static const char* signalName(AlarmSignal signal);
+    static const char* severityName(AlarmSeverity severity);
+
+private:
+    struct RuleState {
+        bool active = false;
+        bool pending = false;        // Condition for the next transition holds
+        uint32_t pending_since = 0;
+    };
+
+    void record(size_t rule, bool raised, float value);
+
+    std::string chemistry;
+    std::vector<AlarmRule> rules;
+    std::vector<RuleState> states;
+    AlarmSeverity severity = ALARM_NONE;
+
+    AlarmEvent history[HISTORY_SIZE];
+    size_t history_head = 0;
+    size_t history_count = 0;
+};
+
+#endif // BATTERY_ALARMS_H
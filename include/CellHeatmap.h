@@ -0,0 +1,63 @@
+#ifndef CELL_HEATMAP_H
+#define CELL_HEATMAP_H
+
+#include "lvgl.h"
+#include "CellStats.h"
+#include "ScreenManager.h"
+#include "SerialProtocol.h"
+
+struct CellHeatmapConfig {
+    uint16_t low_mv = 2800;        // Red end of the scale (Winston discharge cut-off)
+    uint16_t high_mv = 4000;       // Green end (charge cut-off)
+    float weak_sag_mv = 80.0f;     // Outline the lowest cell when it sags this far below the mean
+};
+
+// Per-cell voltage heatmap on its own screen.
+//
+// One tile per cell in an 8-wide grid, coloured by voltage. Each tile
+// remembers what it last showed and is only touched when its text or colour
+// bucket changes, so LVGL only invalidates those tiles - at the BMS frame
+// rate most frames redraw a handful of cells, or none. Built on the first
+// visit (ScreenManager); tap it to go back to the main screen.
+class CellHeatmap : public LazyScreen {
+public:
+    explicit CellHeatmap(CellHeatmapConfig config = CellHeatmapConfig());
+
+    // Data shown on every tick; must outlive the heatmap
+    void setSource(const cell_data_t* cells, const CellStatistics* stats);
+
+    const char* getName() const override { return "cells"; }
+    lv_obj_t* build() override;
+    void release() override;
+    void tick(uint64_t now_ms) override;
+
+    void update(const cell_data_t& cells, const CellStatistics& stats);
+
+private:
+    static constexpr int COLUMNS = 8;
+    static constexpr int COLOR_BUCKETS = 16;
+    static constexpr int FAULT_BUCKET = COLOR_BUCKETS;   // Reading above MAX_CELL_MV
+
+    struct Tile {
+        lv_obj_t* obj = nullptr;
+        lv_obj_t* label = nullptr;
+        uint16_t shown_mv = 0;
+        int bucket = -1;
+        bool outlined = false;
+    };
+
+    void layout(int cell_count);
+    int colorBucket(uint16_t mv) const;
+    void setOutline(Tile& tile, bool outlined);
+
+    CellHeatmapConfig config;
+    const cell_data_t* source_cells = nullptr;
+    const CellStatistics* source_stats = nullptr;
+    lv_obj_t* screen = nullptr;
+    lv_obj_t* lbl_summary = nullptr;
+    Tile tiles[MAX_CELLS];
+    int laid_out_cells = -1;
+    char summary[160] = "";
+};
+
+#endif // CELL_HEATMAP_H
@@ -0,0 +1,58 @@
+#ifndef CELL_STATS_H
+#define CELL_STATS_H
+
+#include "SerialProtocol.h"
+#include <cstddef>
+#include <cstdint>
+
+// Pack statistics over one per-cell frame
+struct CellStatistics {
+    int cell_count = 0;          // In the frame
+    int valid_count = 0;         // Within MAX_CELL_MV; the statistics cover only these
+    int invalid_count = 0;       // Faulted or unpopulated sensors
+    uint16_t min_mv = 0;
+    uint16_t max_mv = 0;
+    int min_index = -1;          // Weakest cell
+    int max_index = -1;
+    float mean_mv = 0.0f;
+    uint16_t spread_mv = 0;      // max - min
+    float imbalance_mv = 0.0f;   // Standard deviation around the mean
+
+    int temp_count = 0;
+    int8_t min_temp_c = 0;
+    int8_t max_temp_c = 0;
+
+    // Weak-cell check: the lowest cell sags this far below the pack mean
+    float weakCellSagMv() const { return mean_mv - min_mv; }
+};
+
+// Vectorised min/max/sum/sum-of-squares over the cell array.
+//
+// NEON on the Pi, SSE2 on x86 for desktop testing, scalar elsewhere. Eight
+// cells per step; all sums stay in 32-bit integers, which is exact only while
+// MAX_CELLS * MAX_CELL_MV^2 < 2^32 and a pair of squares fits SSE2's signed
+// multiply-add. Readings above MAX_CELL_MV (well above any lithium cell) are
+// sensor faults or unpopulated channels: they are counted in invalid_count
+// and left out of min/max/mean/sd, so one bad sensor can't fake a spread.
+// The result is identical on every path. A 64-cell frame is a handful of
+// vector ops - cheap enough for every BMS frame.
+namespace CellStats {
+    static constexpr uint16_t MAX_CELL_MV = 8191;
+    static_assert((uint64_t)MAX_CELLS * MAX_CELL_MV * MAX_CELL_MV < (1ull << 32),
+                  "sum of squares overflows uint32");
+    static_assert(2ull * MAX_CELL_MV * MAX_CELL_MV < (1ull << 31),
+                  "_mm_madd_epi16 pair overflows int32");
+
+
+    // Kernel on raw millivolts; min/max index are the first occurrence, -1
+    // when no reading is valid
+    void computeVoltages(const uint16_t* cell_mv, size_t count, CellStatistics& out);
+
+    // Both voltages and temperatures of a frame
+    CellStatistics compute(const cell_data_t& cells);
+
+    // Name of the kernel compiled in, for the startup log
+    const char* kernelName();
+}
+
+#endif // CELL_STATS_H
@@ -0,0 +1,103 @@
+#ifndef CHART_FEED_H
+#define CHART_FEED_H
+
+#include "TimeSeriesPyramid.h"
+#include <cstddef>
+#include <cstdint>
+
+// Per-pixel-column extremes, oldest column first
+struct ChartColumns {
+    static constexpr size_t MAX_COLUMNS = 288;   // cht_pwusage width
+
+    size_t count = 0;
+    float min[MAX_COLUMNS];
+    float max[MAX_COLUMNS];
+    bool has[MAX_COLUMNS];
+
+    void clear(size_t columns);
+    void merge(size_t column, float lo, float hi);
+
+    // Extremes over all columns; false if every column is empty
+    bool range(float& lo, float& hi) const;
+};
+
+// Axis range last applied to a chart, in chart units
+struct ChartAxisRange {
+    int32_t min = 0;
+    int32_t max = 0;
+};
+
+// Sliding-window minimum or maximum in a monotonic deque: each sample is
+// pushed and popped at most once, so push/expire are amortised O(1) and the
+// extreme is always at the front.
+class MonotonicWindow {
+public:
+    static constexpr size_t CAPACITY = 4096;
+
+    explicit MonotonicWindow(bool keep_max) : keep_max(keep_max) {}
+
+    void push(uint64_t time_ms, float value);
+    // Drop samples older than the window ending at now_ms
+    void expire(uint64_t now_ms, uint64_t window_ms);
+    bool empty() const { return size == 0; }
+    float front() const { return entries[head].value; }
+
+private:
+    struct Entry {
+        uint64_t time_ms;
+        float value;
+    };
+
+    bool keep_max;
+    Entry entries[CAPACITY];
+    size_t head = 0;
+    size_t size = 0;
+};
+
+// One chart signal at ingest rate.
+//
+// Every sample goes into a fixed ring and the window's min/max deques, so a
+// 5 ms current spike between two display frames is still on the chart: the
+// ring is decimated to one min/max pair per pixel column when the chart is
+// drawn, and the deques give the autoscale range without a scan. The dirty
+// flag lets the caller redraw at most once per frame, however many samples
+// arrived in between.
+class ChartFeed {
+public:
+    static constexpr size_t CAPACITY = 4096;   // 68 s at 60 Hz
+
+    explicit ChartFeed(uint64_t window_ms = 60000);
+
+    void add(float value, uint64_t time_ms);
+
+    // True once after new samples
+    bool takeDirty();
+
+    uint64_t getWindowMs() const { return window_ms; }
+
+    // Samples in (now - window, now] into `columns` columns
+    void decimate(uint64_t now_ms, size_t columns, ChartColumns& out);
+
+    // Extremes over the window; false without samples
+    bool extrema(uint64_t now_ms, float& lo, float& hi);
+
+    // Pyramid buckets (oldest first) into columns, for the longer windows
+    static void decimateBuckets(const HistoryBucket* buckets, size_t count, size_t columns, ChartColumns& out);
+
+private:
+    struct Sample {
+        uint64_t time_ms;
+        float value;
+    };
+
+    uint64_t window_ms;
+    Sample samples[CAPACITY];
+    size_t newest = 0;
+    size_t used = 0;
+    bool dirty = false;
+
+    MonotonicWindow window_min{false};
+    MonotonicWindow window_max{true};
+};
+
+#endif // CHART_FEED_H
@@ -0,0 +1,16 @@
+#ifndef DATA_PATHS_H
+#define DATA_PATHS_H
+
+#include <string>
+
+// Where persistent dashboard data lives:
+// $TAZZARI_DATA_DIR, else ~/.local/share/tazzari, else the working directory
+std::string dataDirectory();
+
+// mkdir -p; true if the directory exists afterwards
+bool makeDirectories(const std::string& dir);
+
+// Parent directory of a file path ("." for bare file names)
+std::string directoryOf(const std::string& path);
+
+#endif // DATA_PATHS_H
@@ -0,0 +1,45 @@
+#ifndef DIAGNOSTICS_SCREEN_H
+#define DIAGNOSTICS_SCREEN_H
+
+#include "ScreenManager.h"
+#include "BatteryAlarms.h"
+#include "MetricsExporter.h"
+#include "SerialCommunication.h"
+
+// Diagnostics: serial link counters, frame rate and timings, LVGL heap and
+// resident screens, and the battery alarms with their recent history - the
+// metrics endpoint's numbers, readable in the car.
+class DiagnosticsScreen : public LazyScreen {
+public:
+    static constexpr size_t ALARM_LINES = 8;
+
+    DiagnosticsScreen(const BatteryAlarms& alarms, const LatencyHistogram& loop_latency, const LatencyHistogram& frame_time);
+
+    // From the UI thread once the serial link is up
+    void setSerial(const SerialStats* stats, bool automotive_live, bool bms_live);
+
+    const char* getName() const override { return "diagnostics"; }
+    lv_obj_t* build() override;
+    void release() override;
+    void tick(uint64_t now_ms) override;
+
+private:
+    void showAlarms();
+
+    const BatteryAlarms& alarms;
+    const LatencyHistogram& loop_latency;
+    const LatencyHistogram& frame_time;
+    const SerialStats* serial_stats = nullptr;
+    bool automotive_live = false;
+    bool bms_live = false;
+
+    lv_obj_t* lbl_system = nullptr;
+    lv_obj_t* lbl_alarms = nullptr;
+
+    // Frame rate from the frame counter between ticks
+    uint64_t last_frames = 0;
+    uint64_t last_tick_ms = 0;
+    float fps = 0.0f;
+};
+
+#endif // DIAGNOSTICS_SCREEN_H
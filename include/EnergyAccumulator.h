@@ -0,0 +1,113 @@
+#ifndef ENERGY_ACCUMULATOR_H
+#define ENERGY_ACCUMULATOR_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Energy split by direction; both parts are positive
+struct EnergyTotals {
+    double used_wh = 0.0;      // Discharge
+    double regen_wh = 0.0;     // Charge (regen, or a charger while parked)
+
+    double netWh() const { return used_wh - regen_wh; }
+    void add(const EnergyTotals& other) {
+        used_wh += other.used_wh;
+        regen_wh += other.regen_wh;
+    }
+};
+
+// Wh/km over the last `window_km` driven.
+//
+// Distance is cut into equal bins held in a fixed ring; energy and distance
+// go into the open bin, and when it is full it replaces the oldest one. The
+// running sums make every update and query O(1), with no allocation.
+class RollingConsumption {
+public:
+    static constexpr size_t MAX_BINS = 32;
+
+    explicit RollingConsumption(double window_km = 10.0, size_t bins = 20);
+
+    void add(double net_wh, double km);
+    void reset();
+
+    // Net Wh/km over the window; 0 until min_km has been covered
+    double whPerKm(double min_km = 0.2) const;
+    double getDistanceKm() const { return sum_km + open_km; }
+    double getWindowKm() const { return window_km; }
+
+private:
+    struct Bin {
+        double wh = 0.0;
+        double km = 0.0;
+    };
+
+    double window_km;
+    double bin_km;
+    size_t bins;
+
+    std::array<Bin, MAX_BINS> ring;
+    size_t head = 0;           // Oldest bin once the ring is full
+    size_t used = 0;
+    double sum_wh = 0.0;       // Over the closed bins
+    double sum_km = 0.0;
+    double open_wh = 0.0;      // Bin being filled
+    double open_km = 0.0;
+};
+
+static constexpr size_t CONSUMPTION_WINDOWS = 3;
+
+struct EnergyConfig {
+    // Rolling Wh/km windows, shortest first (TAZZARI_CONSUMPTION_WINDOWS_KM=1,10,50)
+    double window_km[CONSUMPTION_WINDOWS] = {1.0, 10.0, 50.0};
+};
+
+// Integrates pack V*I per BMS frame.
+//
+// Time steps come from the ESP32 frame timestamps rather than receive time,
+// so serial batching and UI stalls don't distort the result; gaps longer
+// than MAX_FRAME_GAP_MS (BMS dropout, ESP32 reboot) are not integrated.
+// Energy per step is the trapezoid between consecutive frames. Charge while
+// standing still is a charger, not regen, and is left out.
+class EnergyAccumulator {
+public:
+    static constexpr uint32_t MAX_FRAME_GAP_MS = 2000;
+    static constexpr size_t WINDOW_COUNT = CONSUMPTION_WINDOWS;
+
+    explicit EnergyAccumulator(EnergyConfig config = EnergyConfig());
+
+    // One BMS frame; returns the energy of the step it closes
+    EnergyTotals addFrame(float voltage, float current, uint32_t timestamp_ms);
+
+    // Distance driven since the last call (from the odometer tick, also
+    // with 0 while stopped)
+    void addDistance(double km);
+
+    // Positive while drawing from the pack, negative while regenerating
+    double getPowerKw() const { return power_kw; }
+
+    const EnergyTotals& getTrip() const { return trip; }
+    const EnergyTotals& getLifetime() const { return lifetime; }
+    void resetTrip() { trip = EnergyTotals(); }
+
+    // Restore persisted totals
+    void restore(const EnergyTotals& trip_totals, const EnergyTotals& lifetime_totals);
+
+    // Rolling windows, shortest first (EnergyConfig::window_km)
+    const RollingConsumption& getWindow(size_t index) const { return windows[index]; }
+
+    static EnergyConfig configFromEnvironment();
+
+private:
+    bool has_frame = false;
+    bool moving = false;
+    uint32_t last_timestamp = 0;
+    double last_power_w = 0.0;
+    double power_kw = 0.0;
+
+    EnergyTotals trip;
+    EnergyTotals lifetime;
+    std::array<RollingConsumption, WINDOW_COUNT> windows;
+};
+
+#endif // ENERGY_ACCUMULATOR_H
@@ -0,0 +1,41 @@
+#ifndef ENERGY_SCREEN_H
+#define ENERGY_SCREEN_H
+
+#include "ScreenManager.h"
+#include "EnergyAccumulator.h"
+#include "RangeEstimator.h"
+#include "TimeSeriesPyramid.h"
+#include <vector>
+
+// Energy detail: power, trip and lifetime totals, consumption over the
+// rolling windows, the range estimate, and power/SOC over the last hour.
+// The hour comes from the history pyramid's 1 min level, so the chart is
+// only redrawn when a new minute starts.
+class EnergyScreen : public LazyScreen {
+public:
+    static constexpr uint64_t CHART_WINDOW_MS = 3600000;
+    static constexpr size_t CHART_POINTS = 60;
+
+    EnergyScreen(const EnergyAccumulator& energy, const RangeEstimator& range, const TimeSeriesPyramid& history);
+
+    const char* getName() const override { return "energy"; }
+    lv_obj_t* build() override;
+    void release() override;
+    void tick(uint64_t now_ms) override;
+
+private:
+    void drawChart(uint64_t now_ms);
+
+    const EnergyAccumulator& energy;
+    const RangeEstimator& range;
+    const TimeSeriesPyramid& history;
+
+    lv_obj_t* lbl_totals = nullptr;
+    lv_obj_t* chart = nullptr;
+    lv_chart_series_t* power_series = nullptr;
+    lv_chart_series_t* soc_series = nullptr;
+    int64_t chart_bucket = -1;
+    std::vector<HistoryBucket> buckets;
+};
+
+#endif // ENERGY_SCREEN_H
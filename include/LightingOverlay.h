@@ -0,0 +1,60 @@
+#ifndef LIGHTING_OVERLAY_H
+#define LIGHTING_OVERLAY_H
+
+#include "lvgl.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Bits of the lighting mask, in the order attach() takes the images
+enum LightingLamp : uint8_t {
+    LAMP_HIGHBEAM   = 1 << 0,
+    LAMP_LOWBEAM    = 1 << 1,
+    LAMP_DRL        = 1 << 2,
+    LAMP_REAR       = 1 << 3,
+    LAMP_REVERSE    = 1 << 4,
+    LAMP_FOG_REAR   = 1 << 5,
+    LAMP_ALL        = 0x3F
+};
+
+// Car lighting drawn by one object from a sprite atlas.
+//
+// The six EEZ overlay images are rendered once at startup and cropped to
+// the pixels they actually cover - most of each full-size overlay is
+// transparent - then kept back to back in one ARGB8888 buffer. Drawing is
+// one blit per lit lamp; a lamp switching on or off invalidates only its
+// cropped area instead of the whole overlay image.
+class LightingOverlay {
+public:
+    static constexpr int LAMPS = 6;
+
+    // Takes over the images' place and z-order and hides them; images in
+    // LightingLamp bit order
+    void attach(lv_obj_t* const images[LAMPS]);
+
+    void setLights(uint8_t mask);
+    uint8_t getLights() const { return lights; }
+
+    lv_obj_t* getObject() const { return obj; }
+
+private:
+    struct Sprite {
+        lv_area_t area;          // Relative to the widget; empty if the image has no visible pixels
+        lv_image_dsc_t image;
+        size_t offset;           // Into atlas
+    };
+
+    static void drawEvent(lv_event_t* e);
+
+    // Crop of one image, appended to the atlas
+    void rasterize(int lamp, lv_obj_t* image, const lv_area_t& coords);
+    void spriteArea(int lamp, lv_area_t& area) const;
+
+    lv_obj_t* obj = nullptr;
+    lv_area_t bounds;            // Union of the source images, absolute at attach time
+    std::vector<uint8_t> atlas;
+    Sprite sprites[LAMPS];
+    uint8_t lights = 0;
+};
+
+#endif // LIGHTING_OVERLAY_H
@@ -0,0 +1,70 @@
+#ifndef METRICS_EXPORTER_H
+#define METRICS_EXPORTER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Fixed-bucket latency histogram, safe to update from any thread.
+// Exposed as a Prometheus histogram so p50/p99 can be derived server-side.
+class LatencyHistogram {
+public:
+    static constexpr int BUCKET_COUNT = 12;
+
+    void observe(double ms);
+    void observeSince(std::chrono::steady_clock::time_point start);
+
+    uint64_t getCount() const { return count.load(std::memory_order_relaxed); }
+    double getMaxMs() const { return max_us.load(std::memory_order_relaxed) / 1000.0; }
+
+    void write(std::ostream& out, const char* name, const char* help) const;
+
+private:
+    static const double BUCKET_BOUNDS_MS[BUCKET_COUNT];
+
+    std::atomic<uint64_t> buckets[BUCKET_COUNT] = {};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum_us{0};
+    std::atomic<uint64_t> max_us{0};
+};
+
+// Prometheus text exporter on a localhost HTTP port (GET /metrics).
+// Runs its own thread; collectors are called on that thread at scrape time
+// and must only read thread-safe state (atomics).
+class MetricsExporter {
+public:
+    explicit MetricsExporter(int port = 9110);
+    ~MetricsExporter();
+
+    bool start();
+    void stop();
+
+    void addCollector(std::function<void(std::ostream&)> collector);
+
+    // Text format helpers for collectors
+    static void writeGauge(std::ostream& out, const char* name, const char* help, double value);
+    static void writeCounter(std::ostream& out, const char* name, const char* help, double value);
+
+private:
+    void serverLoop();
+    void handleClient(int client_fd);
+    std::string renderPage();
+    void writeProcessMetrics(std::ostream& out);
+
+    int port;
+    int listen_fd = -1;
+    std::atomic<bool> running{false};
+    std::thread server_thread;
+
+    std::mutex collectors_mutex;
+    std::vector<std::function<void(std::ostream&)>> collectors;
+    std::atomic<uint64_t> scrapes{0};
+};
+
+#endif // METRICS_EXPORTER_H
@@ -0,0 +1,104 @@
+#ifndef ODOMETER_STORE_H
+#define ODOMETER_STORE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Persisted dashboard state
+struct OdometerState {
+    double odo_km = 0.0;
+    double trip_km = 0.0;
+    float soc_percent = 0.0f;
+    bool soc_valid = false;
+    
+    // Energy accounting (kWh) - zero in records written before it existed
+    float trip_used_kwh = 0.0f;
+    float trip_regen_kwh = 0.0f;
+    float lifetime_used_kwh = 0.0f;
+    float lifetime_regen_kwh = 0.0f;
+    float learned_wh_per_km = 0.0f;     // Range estimator; 0 = nothing learned yet
+};
+
+// On-disk record - one per slot, validated by magic, version and CRC
+struct OdometerRecord {
+    uint32_t magic;         // ODOMETER_MAGIC
+    uint16_t version;       // ODOMETER_VERSION
+    uint16_t size;          // sizeof(OdometerRecord)
+    uint64_t sequence;      // Monotonic, newest valid record wins
+    double odo_km;
+    double trip_km;
+    float soc_percent;
+    uint32_t flags;         // ODOMETER_FLAG_*
+    float trip_used_kwh;    // Were reserved (zero) in early version 1 records
+    float trip_regen_kwh;
+    float lifetime_used_kwh;
+    float lifetime_regen_kwh;
+    float learned_wh_per_km;
+    uint32_t crc;           // CRC-32 over all preceding bytes
+};
+static_assert(sizeof(OdometerRecord) == 64, "OdometerRecord layout changed");
+
+#define ODOMETER_MAGIC          0x444F5A54u  // "TZOD"
+#define ODOMETER_VERSION        1
+#define ODOMETER_FLAG_SOC_VALID 0x01u
+
+// Crash-safe journal of fixed-size records for ODO/trip/SOC.
+//
+// The file holds SLOT_COUNT preallocated sector-sized slots. Each save
+// writes the next slot in turn (one sector, then fdatasync), so writes are
+// spread over the file instead of rewriting the same blocks, and a power
+// cut can at worst tear the slot being written - the CRC rejects it and
+// the previous record is still intact. open() scans all slots and
+// recovers the record with the highest sequence number.
+class OdometerStore {
+public:
+    static constexpr int SLOT_COUNT = 64;
+    static constexpr size_t SLOT_SIZE = 512;   // One SD sector per write
+    static constexpr size_t FILE_SIZE = SLOT_COUNT * SLOT_SIZE;
+
+    explicit OdometerStore(const std::string& path = defaultPath());
+    ~OdometerStore();
+
+    // Create/preallocate the journal if needed and recover the newest record
+    bool open();
+    void close();
+
+    // Newest valid state found by open() or written by save()
+    bool hasState() const { return has_state; }
+    const OdometerState& getState() const { return state; }
+
+    // Write one record and fdatasync it
+    bool save(const OdometerState& new_state);
+
+    const std::string& getPath() const { return path; }
+
+    // Statistics for the metrics exporter
+    uint64_t getWriteCount() const { return write_count.load(std::memory_order_relaxed); }
+    uint64_t getBytesWritten() const { return bytes_written.load(std::memory_order_relaxed); }
+    uint64_t getRecoveryTimeUs() const { return recovery_time_us.load(std::memory_order_relaxed); }
+
+    // odometer.jrnl in dataDirectory()
+    static std::string defaultPath();
+
+    // Record encode/validate - exposed for offline inspection tools
+    static void encodeRecord(const OdometerState& state, uint64_t sequence, OdometerRecord& record);
+    static bool isValidRecord(const OdometerRecord& record);
+
+private:
+    bool preallocate();
+    void recover();
+
+    std::string path;
+    int fd = -1;
+
+    OdometerState state;
+    bool has_state = false;
+    uint64_t next_sequence = 1;
+
+    std::atomic<uint64_t> write_count{0};
+    std::atomic<uint64_t> bytes_written{0};
+    std::atomic<uint64_t> recovery_time_us{0};
+};
+
+#endif // ODOMETER_STORE_H
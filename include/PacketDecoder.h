@@ -0,0 +1,57 @@
+#ifndef PACKET_DECODER_H
+#define PACKET_DECODER_H
+
+#include "SerialProtocol.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+enum PacketError {
+    PACKET_ERROR_FRAMING,    // Unknown type, zero length or missing end byte
+    PACKET_ERROR_CHECKSUM,
+};
+
+// Byte-stream framing for the ESP32 serial protocol:
+//   START, type, length, payload[length], checksum, END
+// with checksum = XOR of type, length and payload.
+//
+// Shared by SerialCommunication and the offline log tool so live data and
+// raw captures are parsed by the same code.
+class PacketDecoder {
+public:
+    using PacketCallback = std::function<void(uint8_t type, const uint8_t* payload, uint8_t length)>;
+    using ErrorCallback = std::function<void(PacketError error)>;
+
+    void setPacketCallback(PacketCallback callback) { packet_callback = callback; }
+    void setErrorCallback(ErrorCallback callback) { error_callback = callback; }
+
+    // Any chunking of the stream is fine - state carries across calls
+    void feed(const uint8_t* data, size_t length);
+    void reset() { state = STATE_START; }
+
+    static bool isKnownType(uint8_t type);
+
+    // Payload to struct; false if the size doesn't match (ESP32 layout mismatch)
+    static bool decodeBMS(const uint8_t* payload, uint8_t length, bms_data_t& out);
+    static bool decodeAutomotive(const uint8_t* payload, uint8_t length, automotive_data_t& out);
+    static bool decodeCells(const uint8_t* payload, uint8_t length, cell_data_t& out);
+
+private:
+    enum State {
+        STATE_START, STATE_TYPE, STATE_LENGTH, STATE_PAYLOAD, STATE_CHECKSUM, STATE_END
+    };
+
+    void error(PacketError error);
+
+    State state = STATE_START;
+    uint8_t packet_type = 0;
+    uint8_t packet_length = 0;
+    uint8_t checksum = 0;
+    int data_index = 0;
+    uint8_t payload[256];
+
+    PacketCallback packet_callback;
+    ErrorCallback error_callback;
+};
+
+#endif // PACKET_DECODER_H
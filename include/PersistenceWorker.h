@@ -0,0 +1,70 @@
+#ifndef PERSISTENCE_WORKER_H
+#define PERSISTENCE_WORKER_H
+
+#include "OdometerStore.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// When a pending snapshot is worth an SD card write
+struct PersistencePolicy {
+    double min_distance_km = 0.1;                       // ODO or trip moved this far
+    std::chrono::milliseconds max_interval{30000};      // Any change, at least this often
+};
+
+// Moves OdometerStore writes off the render thread.
+//
+// submit() only copies the snapshot under a mutex; the worker keeps just
+// the newest one (older unsaved snapshots are coalesced away) and writes
+// it when the policy says so. flush() forces the next write, stop() writes
+// whatever is pending and joins - call it on every shutdown path.
+//
+// post() queues other slow storage work (e.g. trip appends) onto the same
+// thread so the SD card only ever sees one writer. Jobs run in order and
+// all queued jobs run before stop() returns.
+class PersistenceWorker {
+public:
+    explicit PersistenceWorker(OdometerStore& store, PersistencePolicy policy = PersistencePolicy());
+    ~PersistenceWorker();
+
+    void start();
+    void stop();
+
+    void submit(const OdometerState& state);
+    void flush();
+    void post(std::function<void()> job);
+
+    // Statistics for the metrics exporter
+    uint64_t getSubmitted() const { return submitted.load(std::memory_order_relaxed); }
+    uint64_t getWrites() const { return writes.load(std::memory_order_relaxed); }
+
+private:
+    void workerLoop();
+    bool shouldWrite(const OdometerState& state, std::chrono::steady_clock::time_point now) const;
+    bool write(const OdometerState& state, std::chrono::steady_clock::time_point now);
+
+    OdometerStore& store;
+    PersistencePolicy policy;
+
+    std::thread worker_thread;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool running = false;
+    bool has_pending = false;
+    bool flush_requested = false;
+    OdometerState pending;
+    std::deque<std::function<void()>> jobs;
+
+    // Worker thread only
+    OdometerState last_written;
+    std::chrono::steady_clock::time_point last_write_time;
+
+    std::atomic<uint64_t> submitted{0};
+    std::atomic<uint64_t> writes{0};
+};
+
+#endif // PERSISTENCE_WORKER_H
@@ -0,0 +1,20 @@
+#ifndef PIXEL_CONVERT_H
+#define PIXEL_CONVERT_H
+
+#include <cstddef>
+#include <cstdint>
+
+// RGB565 -> XRGB8888 for the 16-bit profile's flush when the SDL renderer
+// has no RGB565 texture format.
+//
+// NEON on the Pi, SSE2 on x86, scalar elsewhere; eight pixels per step.
+// Channels are widened by bit replication (0x1F -> 0xFF), so white stays
+// white and every path gives the same bytes.
+namespace PixelConvert {
+    void rgb565ToXrgb8888(const uint16_t* src, uint32_t* dst, size_t count);
+
+    // Name of the kernel compiled in, for the startup log
+    const char* kernelName();
+}
+
+#endif // PIXEL_CONVERT_H
@@ -0,0 +1,75 @@
+#ifndef POWER_STATE_MACHINE_H
+#define POWER_STATE_MACHINE_H
+
+#include <cstdint>
+
+enum PowerState {
+    POWER_DRIVING = 0,
+    POWER_PARKED,           // Stationary, handbrake or neutral
+    POWER_CHARGING,         // Stationary (or ignition off), current into the pack
+    POWER_IGNITION_OFF,     // No vehicle frames
+    POWER_STANDBY,          // No vehicle frames for standby_after_ms
+    POWER_STATE_COUNT
+};
+
+// What each state costs. The Pi and the ESP32 run off the car's 12 V
+// battery, so everything that wakes the CPU scales with the state.
+struct PowerProfile {
+    uint32_t refresh_ms;        // LVGL display refresh timer; 0 = paused
+    uint32_t input_ms;          // Touch/SDL event polling
+    uint32_t update_ms;         // Labels, lighting and detail screen ticks
+    uint32_t chart_ms;          // Minimum time between power chart redraws
+    uint32_t audio_poll_ms;     // Bluetooth/DSP status polling; 0 = off
+};
+
+struct PowerInputs {
+    bool vehicle_live = false;       // Automotive frames within their timeout
+    uint64_t silent_ms = 0;          // Since the last vehicle frame
+    uint64_t idle_ms = 0;            // Since the last vehicle frame or touch
+    float speed_kmh = 0.0f;
+    bool in_gear = false;            // D or R
+    bool handbrake = false;
+    bool bms_live = false;
+    float current_a = 0.0f;          // Negative while discharging
+};
+
+struct PowerConfig {
+    uint32_t ignition_off_ms = 5000;        // Frames missing this long = ignition off
+    uint32_t standby_after_ms = 600000;     // TAZZARI_STANDBY_MINUTES, default 10; 0 = never
+    uint32_t park_after_ms = 3000;          // Stationary this long before leaving DRIVING
+    float moving_kmh = 1.0f;
+    float charge_current_a = 1.0f;          // Into the pack while stationary
+};
+
+// Power state from vehicle data.
+//
+// Moving, or in gear with the handbrake off, is DRIVING right away; the
+// other states need their condition to hold for park_after_ms first, so a
+// stop at a junction keeps the full frame rate. Missing vehicle frames go
+// to IGNITION_OFF, and after standby_after_ms without frames or touches to
+// STANDBY, where the main loop stops rendering and sleeps in poll() on the
+// serial port - the next frame or a tap wakes it straight back up.
+class PowerStateMachine {
+public:
+    explicit PowerStateMachine(PowerConfig config = configFromEnvironment());
+
+    // Returns true when the state changed
+    bool update(const PowerInputs& inputs, uint64_t now_ms);
+
+    PowerState getState() const { return state; }
+    const PowerProfile& getProfile() const { return PROFILES[state]; }
+
+    static const PowerProfile PROFILES[POWER_STATE_COUNT];
+    static const char* stateName(PowerState state);
+    static PowerConfig configFromEnvironment();
+
+private:
+    PowerState classify(const PowerInputs& inputs) const;
+
+    PowerConfig config;
+    PowerState state = POWER_DRIVING;
+    PowerState pending = POWER_DRIVING;
+    uint64_t pending_since = 0;
+};
+
+#endif // POWER_STATE_MACHINE_H
@@ -0,0 +1,58 @@
+#ifndef RANGE_ESTIMATOR_H
+#define RANGE_ESTIMATOR_H
+
+#include "EnergyAccumulator.h"
+
+struct RangeConfig {
+    double pack_kwh = 12.3;            // 24x ThunderSky Winston 160Ah (TAZZARI_PACK_KWH)
+    double reserve_percent = 5.0;      // SOC treated as empty
+    double default_wh_per_km = 90.0;   // Until something has been learned
+    double learn_distance_km = 100.0;  // Memory of the learned consumption
+};
+
+struct RangeEstimate {
+    bool valid = false;
+    double km = 0.0;
+    double low_km = 0.0;               // Confidence band
+    double high_km = 0.0;
+    double wh_per_km = 0.0;            // Blended consumption used for km
+};
+
+// Remaining range from SOC and a blend of consumption estimates.
+//
+// The EnergyAccumulator's rolling windows (1, 10, 50 km by default) are blended with a
+// long-term learned value. Short windows get more weight so the estimate
+// follows the current driving, but each window only counts in proportion
+// to how much of it has been driven, so after a restart the learned value
+// dominates. The band spans the range at the lowest and highest of the
+// contributing consumptions. update() is O(1) and doesn't allocate.
+class RangeEstimator {
+public:
+    explicit RangeEstimator(RangeConfig config = RangeConfig());
+
+    // Every tick, after the odometer and energy updates
+    void update(const EnergyAccumulator& energy, double distance_km, float soc_percent, bool soc_valid);
+
+    const RangeEstimate& getEstimate() const { return estimate; }
+
+    // Long-term consumption, persisted in the odometer journal; 0 until a
+    // learning step has completed (the estimate uses default_wh_per_km then)
+    double getLearnedWhPerKm() const { return learned_wh_per_km; }
+    void restoreLearned(double wh_per_km);
+
+    static RangeConfig configFromEnvironment();
+
+private:
+    void learn(const EnergyAccumulator& energy, double distance_km);
+    double longTermWhPerKm() const;
+
+    RangeConfig config;
+    RangeEstimate estimate;
+
+    double learned_wh_per_km = 0.0;
+    double learn_km = 0.0;              // Distance since the last learning step
+    double learn_start_wh = 0.0;        // Lifetime net Wh at its start
+    bool learn_started = false;
+};
+
+#endif // RANGE_ESTIMATOR_H
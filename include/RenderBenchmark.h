@@ -0,0 +1,47 @@
+#ifndef RENDER_BENCHMARK_H
+#define RENDER_BENCHMARK_H
+
+#include <lvgl.h>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Fixed-scene render benchmark for comparing the 32-bit and RGB565 builds.
+//
+//   TAZZARI_RENDER_BENCH=300 ./build/LVGLDashboard_dev
+//
+// Every scene changes the UI the same way each frame and forces a refresh
+// with lv_refr_now, so both profiles draw identical frames. Per scene it
+// reports frame time (mean/p95/p99/max, render + flush) and the area LVGL
+// invalidated times the display's bytes per pixel - the render buffer
+// traffic each frame costs at that colour depth.
+class RenderBenchmark {
+public:
+    using Step = std::function<void(uint32_t frame)>;
+
+    explicit RenderBenchmark(lv_display_t* display);
+
+    void addScene(const std::string& name, Step step);
+
+    // Runs every scene for `frames` refreshes and prints one row per scene
+    void run(uint32_t frames, std::ostream& out);
+
+    // TAZZARI_RENDER_BENCH=<frames per scene>; 0 when unset
+    static uint32_t framesFromEnvironment();
+
+private:
+    struct Scene {
+        std::string name;
+        Step step;
+    };
+
+    static void invalidateEvent(lv_event_t* e);
+
+    lv_display_t* display;
+    std::vector<Scene> scenes;
+    uint64_t invalidated_pixels = 0;
+};
+
+#endif // RENDER_BENCHMARK_H
@@ -0,0 +1,105 @@
+#ifndef SCREEN_MANAGER_H
+#define SCREEN_MANAGER_H
+
+#include "lvgl.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ScreenManager;
+
+// A screen that is built on its first visit and may be deleted again
+class LazyScreen {
+public:
+    virtual ~LazyScreen() = default;
+
+    virtual const char* getName() const = 0;
+
+    // Create a new screen object with everything on it and return it
+    virtual lv_obj_t* build() = 0;
+
+    // The screen's objects have been deleted; drop every pointer into them
+    virtual void release() = 0;
+
+    // Refresh from live data; only called while the screen is shown
+    virtual void tick(uint64_t now_ms) { (void)now_ms; }
+
+protected:
+    friend class ScreenManager;
+
+    // lv_label_set_text always invalidates; skip it when the text is the same
+    static void setLabelText(lv_obj_t* label, const char* text);
+
+    // White label at (x, y) on `parent`
+    static lv_obj_t* createLabel(lv_obj_t* parent, const lv_font_t* font, int32_t x, int32_t y);
+
+    // Black, non-scrolling screen with a title in the top left corner
+    static lv_obj_t* createScreen(const char* title);
+
+    ScreenManager* manager = nullptr;
+};
+
+// Swipe navigation over the EEZ main screen and the lazy screens.
+//
+// Screens are built on the first visit and stay resident while the LVGL
+// heap they took (measured around build()) fits the budget; beyond that the
+// least recently shown ones are deleted and rebuilt on the next visit. Only
+// the shown screen is rendered and ticked, so background screens cost no
+// render or update time, and memory is bounded by the budget plus the
+// screen just left (kept while it slides out). Swipe left for
+// the next screen, right for the previous one.
+class ScreenManager {
+public:
+    static constexpr size_t DEFAULT_BUDGET = 96 * 1024;
+    static constexpr uint32_t ANIM_MS = 200;
+
+    explicit ScreenManager(size_t budget_bytes = DEFAULT_BUDGET);
+
+    // Index 0, always resident
+    void setHome(lv_obj_t* screen);
+    // Indices 1.. in swipe order
+    void add(LazyScreen* screen);
+
+    void show(size_t index);
+    void show(LazyScreen* screen);
+    void showHome() { show((size_t)0); }
+    void showNext();
+    void showPrevious();
+
+    // Ticks the shown screen
+    void tick(uint64_t now_ms);
+
+    bool isShown(const LazyScreen* screen) const;
+    size_t getCurrent() const { return current; }
+    size_t getScreenCount() const { return entries.size() + 1; }
+    size_t getResidentBytes() const;
+    size_t getResidentCount() const;
+    size_t getBudget() const { return budget; }
+
+    // TAZZARI_SCREEN_BUDGET_KB, else DEFAULT_BUDGET
+    static size_t budgetFromEnvironment();
+
+private:
+    struct Entry {
+        LazyScreen* screen = nullptr;
+        lv_obj_t* obj = nullptr;     // nullptr while not built
+        size_t bytes = 0;
+        uint64_t last_shown = 0;
+    };
+
+    static void gestureEvent(lv_event_t* e);
+    static size_t heapUsed();
+
+    lv_obj_t* objectAt(size_t index);
+    void build(Entry& entry);
+    void evict(lv_obj_t* outgoing);
+
+    size_t budget;
+    lv_obj_t* home = nullptr;
+    std::vector<Entry> entries;
+    size_t current = 0;
+    uint64_t show_count = 0;
+    uint64_t last_tick_ms = 0;
+};
+
+#endif // SCREEN_MANAGER_H
@@ -0,0 +1,100 @@
+#ifndef SDL_DISPLAY_H
+#define SDL_DISPLAY_H
+
+#include <lvgl.h>
+#include <cstdint>
+#include <vector>
+
+struct SDL_Window;
+struct SDL_Renderer;
+struct SDL_Texture;
+
+// Render buffering, from the environment so one build can be benchmarked
+// in every combination:
+//   TAZZARI_RENDER_MODE     partial | direct | full    (default partial)
+//   TAZZARI_DRAW_BUF_LINES  lines per buffer, partial only (default 60)
+//   TAZZARI_DRAW_BUF_COUNT  1 or 2 (default 2)
+struct SdlDisplayConfig {
+    lv_display_render_mode_t render_mode = LV_DISPLAY_RENDER_MODE_PARTIAL;
+    int32_t buffer_lines = 60;
+    int buffer_count = 2;
+
+    static SdlDisplayConfig fromEnvironment();
+    const char* renderModeName() const;
+};
+
+// SDL window, flush and pointer input.
+//
+// Partial mode renders the invalidated areas band by band into small
+// buffers; with two of them LVGL draws the next band while the last one is
+// uploaded. Direct and full mode render into screen-sized buffers - more
+// memory, but LVGL does not split large areas into bands, and direct mode
+// uploads only what changed.
+//
+// In the RGB565 profile (COLOR_DEPTH_16) each area goes straight into an
+// RGB565 streaming texture when the renderer lists that format (the
+// software renderer). SDL's GLES2 renderer on the Pi only takes 32-bit
+// textures, so there the area is widened with PixelConvert into an XRGB8888
+// texture - instead of SDL's generic per-pixel converter. The texture is
+// presented once per refresh, after the last area.
+//
+// Closing the window raises SIGTERM so the dashboard shuts down through
+// stop() and the final odometer flush.
+class SdlDisplay {
+public:
+    SdlDisplay() = default;
+    ~SdlDisplay();
+
+    SdlDisplay(const SdlDisplay&) = delete;
+    SdlDisplay& operator=(const SdlDisplay&) = delete;
+
+    // nullptr if SDL could not open a window
+    lv_display_t* create(int32_t width, int32_t height, bool fullscreen,
+                         const SdlDisplayConfig& config = SdlDisplayConfig());
+
+    lv_indev_t* getPointer() const { return pointer; }
+
+    // Display refresh and input polling periods. refresh_ms 0 pauses
+    // rendering and the LVGL pointer until the next call with a period;
+    // SDL events are still drained every STANDBY_EVENT_MS so closing the
+    // window and waking taps keep working
+    void setTimerPeriods(uint32_t refresh_ms, uint32_t input_ms);
+
+    // True once after a press since the last call
+    bool takeActivity();
+
+    static constexpr uint32_t STANDBY_EVENT_MS = 250;
+
+    // True when RGB565 flushes are converted to XRGB8888
+    bool isConverting() const { return converting; }
+
+private:
+    static void flushCallback(lv_display_t* disp, const lv_area_t* area, uint8_t* px_map);
+    static void pointerRead(lv_indev_t* indev, lv_indev_data_t* data);
+    static void pollEvents(lv_timer_t* timer);
+
+    void flush(lv_display_t* disp, const lv_area_t* area, uint8_t* px_map);
+
+    SDL_Window* window = nullptr;
+    SDL_Renderer* renderer = nullptr;
+    SDL_Texture* texture = nullptr;
+    lv_display_t* display = nullptr;
+    lv_indev_t* pointer = nullptr;
+    lv_timer_t* event_timer = nullptr;
+    bool converting = false;
+    bool activity = false;
+
+    SdlDisplayConfig config;
+    lv_color_format_t color_format = LV_COLOR_FORMAT_NATIVE;
+    uint32_t screen_stride = 0;          // Direct/full buffers hold the whole screen
+
+    std::vector<uint8_t> draw_buf_1;
+    std::vector<uint8_t> draw_buf_2;
+    std::vector<uint32_t> converted;     // One area in XRGB8888
+
+    int32_t pointer_x = 0;
+    int32_t pointer_y = 0;
+    bool pointer_pressed = false;
+};
+
+#endif // SDL_DISPLAY_H
@@ -6,40 +6,18 @@
 #include <chrono>
 #include <cstdint>
 
-// Serial communication protocol - MUST MATCH ESP32 SENDER
-#define PACKET_START_BYTE   0xAA
-#define PACKET_END_BYTE     0x55
-#define BMS_PACKET_TYPE     0x01
-#define AUTO_PACKET_TYPE    0x02
+#include "SerialProtocol.h"
+#include "PacketDecoder.h"
 
-// Data structures - copied from ESP32 implementation
-typedef struct {
-    float current;         // Current in Amperes (+ charging, - discharging)
-    float totalVoltage;    // Total pack voltage
-    float soc;             // State of charge percentage (0-100)
-    float minVoltage;      // Minimum cell voltage
-    float maxVoltage;      // Maximum cell voltage
-    float minTemp;         // Minimum temperature
-    float maxTemp;         // Maximum temperature
-    uint32_t timestamp;    // Timestamp
-    bool dataValid;        // Data validity flag
-} bms_data_t;
-
-typedef struct {
-    bool reverse;
-    bool forward;
-    bool abblendlicht;
-    bool vollicht;
-    bool nebelHinten;
-    bool indicatorLeft;
-    bool indicatorRight;
-    bool bremsfluid;
-    bool handbremse;
-    bool lightOn;           // Running lights ON signal
-    float speed_kmh;
-    uint16_t rpm;
-    uint32_t timestamp;
-} automotive_data_t;
+// Link statistics - atomics so the metrics thread can read them
+struct SerialStats {
+    std::atomic<uint64_t> bytes_received{0};
+    std::atomic<uint64_t> bms_packets{0};
+    std::atomic<uint64_t> auto_packets{0};
+    std::atomic<uint64_t> cell_packets{0};
+    std::atomic<uint64_t> checksum_errors{0};
+    std::atomic<uint64_t> framing_errors{0};   // Bad type/length, missing end byte
+};
 
 class SerialCommunication {
 public:
@@ -59,6 +37,8 @@ public:
     // Data access
     const automotive_data_t& getAutomotiveData() const { return received_auto_data; }
     const bms_data_t& getBMSData() const { return received_bms_data; }
+    const cell_data_t& getCellData() const { return received_cell_data; }
+    const SerialStats& getStats() const { return stats; }
     
     // Check for new data
     bool hasNewAutomotiveData();
@@ -68,9 +48,13 @@ public:
     bool isAutomotiveDataValid(int timeout_ms = 500);
     bool isBMSDataValid(int timeout_ms = 2000);
     
+    // Block until bytes arrive or timeout_ms passes (standby); true if readable
+    bool waitForData(int timeout_ms);
+    
     // Set data callbacks
     void setAutomotiveDataCallback(std::function<void(const automotive_data_t&)> callback);
     void setBMSDataCallback(std::function<void(const bms_data_t&)> callback);
+    void setCellDataCallback(std::function<void(const cell_data_t&)> callback);
 
 private:
     // Serial configuration
@@ -78,19 +62,17 @@ private:
     int baud_rate;
     int serial_fd = -1;
     
-    // Packet receiving state machine
-    uint8_t packet_buffer[256];
-    int packet_state = 0;
-    uint8_t packet_type = 0;
-    uint8_t packet_length = 0;
-    int data_index = 0;
+    // Packet framing
+    PacketDecoder decoder;
     
     // Received data
     automotive_data_t received_auto_data = {0};
     bms_data_t received_bms_data = {0};
+    cell_data_t received_cell_data = {0};
     
     // Data flags
     std::atomic<bool> new_auto_data{false};
+    SerialStats stats;
     std::atomic<bool> new_bms_data{false};
     
     // Timing
@@ -100,11 +82,12 @@ private:
     // Callbacks
     std::function<void(const automotive_data_t&)> auto_callback;
     std::function<void(const bms_data_t&)> bms_callback;
+    std::function<void(const cell_data_t&)> cell_callback;
     
     // Internal methods
     bool setupSerial();
-    uint8_t calculateChecksum(uint8_t* data, size_t length);
-    void handleReceivedPacket();
+    void handlePacketError(PacketError error);
+    void handleReceivedPacket(uint8_t packet_type, const uint8_t* payload, uint8_t packet_length);
     uint32_t getCurrentTimeMs();
 };
 
@@ -0,0 +1,56 @@
+#ifndef SERIAL_PROTOCOL_H
+#define SERIAL_PROTOCOL_H
+
+#include <cstdint>
+
+// Serial communication protocol - MUST MATCH ESP32 SENDER
+#define PACKET_START_BYTE   0xAA
+#define PACKET_END_BYTE     0x55
+#define BMS_PACKET_TYPE     0x01
+#define AUTO_PACKET_TYPE    0x02
+#define CELL_PACKET_TYPE    0x03
+
+#define MAX_CELLS           64
+
+// Data structures - copied from ESP32 implementation
+typedef struct {
+    float current;         // Current in Amperes (+ charging, - discharging)
+    float totalVoltage;    // Total pack voltage
+    float soc;             // State of charge percentage (0-100)
+    float minVoltage;      // Minimum cell voltage
+    float maxVoltage;      // Maximum cell voltage
+    float minTemp;         // Minimum temperature
+    float maxTemp;         // Maximum temperature
+    uint32_t timestamp;    // Timestamp
+    bool dataValid;        // Data validity flag
+} bms_data_t;
+
+typedef struct {
+    bool reverse;
+    bool forward;
+    bool abblendlicht;
+    bool vollicht;
+    bool nebelHinten;
+    bool indicatorLeft;
+    bool indicatorRight;
+    bool bremsfluid;
+    bool handbremse;
+    bool lightOn;           // Running lights ON signal
+    float speed_kmh;
+    uint16_t rpm;
+    uint32_t timestamp;
+} automotive_data_t;
+
+// Per-cell packet. Variable length on the wire (little endian, packed):
+//   uint32 timestamp, uint8 cell_count, uint8 temp_count,
+//   uint16 cell_mv[cell_count], int8 temp_c[temp_count]
+// 64 cells and 64 sensors is 198 bytes, inside the one-byte length field.
+typedef struct {
+    uint32_t timestamp;
+    uint8_t cell_count;
+    uint8_t temp_count;
+    uint16_t cell_mv[MAX_CELLS];   // Cell voltage in mV
+    int8_t temp_c[MAX_CELLS];      // Sensor temperature in degrees C
+} cell_data_t;
+
+#endif // SERIAL_PROTOCOL_H
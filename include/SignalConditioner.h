@@ -0,0 +1,92 @@
+#ifndef SIGNAL_CONDITIONER_H
+#define SIGNAL_CONDITIONER_H
+
+#include <cstdint>
+
+struct SignalFilterConfig {
+    int median = 1;              // Median-of-N spike rejection (1 = off, max MAX_MEDIAN)
+    uint32_t tau_ms = 0;         // IIR low-pass time constant (0 = off)
+    float max_rate = 0.0f;       // Rate limit in units per second (0 = off)
+    float display_step = 1.0f;   // Resolution of the displayed value
+    float display_hysteresis = 0.25f;  // Extra steps the value has to move before the display follows
+};
+
+// One signal through median -> IIR low-pass -> rate limit, in Q16.16.
+//
+// Every stage works on sample timestamps rather than a fixed rate, so the
+// filters behave the same whether the ESP32 sends at 10 Hz or 50 Hz and
+// across dropped frames: the IIR factor is dt / (tau + dt) per sample and
+// the rate limit allows max_rate * dt. The display value is quantised to
+// display_step with hysteresis, so a value sitting on a rounding boundary
+// doesn't make its label flip every frame.
+class SignalFilter {
+public:
+    static constexpr int MAX_MEDIAN = 7;
+    static constexpr uint32_t MAX_GAP_MS = 2000;   // Longer gaps restart the filter
+
+    explicit SignalFilter(SignalFilterConfig config = SignalFilterConfig());
+
+    // Returns the filtered value
+    float update(float value, uint32_t timestamp_ms);
+    void reset();
+
+    bool hasValue() const { return has_value; }
+    float getValue() const { return fromFixed(filtered); }
+    float getDisplay() const { return display; }
+
+    // Change of the filtered value over the last step, per second
+    float getSlope() const { return slope; }
+
+private:
+    static int32_t toFixed(float value);
+    static float fromFixed(int32_t value) { return value / 65536.0f; }
+
+    int32_t median(int32_t sample);
+    void updateDisplay(bool first);
+
+    SignalFilterConfig config;
+    bool has_value = false;
+    uint32_t last_timestamp = 0;
+    int32_t filtered = 0;
+    float slope = 0.0f;
+    float display = 0.0f;
+
+    int32_t window[MAX_MEDIAN];
+    int window_used = 0;
+    int window_next = 0;
+};
+
+struct SignalConditionerConfig {
+    SignalFilterConfig speed{3, 300, 40.0f, 1.0f, 0.25f};      // km/h
+    SignalFilterConfig soc{5, 10000, 1.0f, 1.0f, 0.25f};       // %
+    uint32_t acceleration_tau_ms = 500;
+};
+
+// Conditioned speed and SOC for display, fed at ingest rate from the
+// serial callbacks with the ESP32 timestamps. The raw values stay in use
+// for integration (odometer, energy) and for the power chart, which plots
+// raw current so short spikes stay visible; these are for what is shown.
+class SignalConditioner {
+public:
+    explicit SignalConditioner(SignalConditionerConfig config = SignalConditionerConfig());
+
+    void addSpeed(float kmh, uint32_t timestamp_ms);
+    void addSoc(float percent, uint32_t timestamp_ms);
+
+    // Link lost - next samples start fresh instead of ramping from stale values
+    void resetSpeed();
+    void resetBattery();
+
+    const SignalFilter& getSpeed() const { return speed; }
+    const SignalFilter& getSoc() const { return soc; }
+
+    // Longitudinal acceleration in m/s^2 from the filtered speed
+    float getAcceleration() const { return acceleration.getValue(); }
+
+private:
+    SignalFilter speed;
+    SignalFilter soc;
+    SignalFilter acceleration;
+};
+
+#endif // SIGNAL_CONDITIONER_H
@@ -5,6 +5,7 @@
 #include <functional>
 #include <chrono>
 #include <atomic>
+#include "MetricsExporter.h"
 
 enum class SimplePlaybackState {
     STOPPED,
@@ -59,6 +60,13 @@ public:
     
     // Update method (call every few seconds)
     void update();
+    
+    // Minimum time between update() polls (default 10 s)
+    void setPollInterval(uint32_t ms) { poll_interval_ms = ms; }
+    
+    // REST call statistics (read by the metrics exporter)
+    const LatencyHistogram& getRestLatency() const { return rest_latency; }
+    uint64_t getRestFailures() const { return rest_failures.load(std::memory_order_relaxed); }
 
 private:
     // REST API Communication
@@ -83,11 +91,16 @@ private:
     SimpleMediaInfo current_info;
     std::function<void(const SimpleMediaInfo&)> state_callback;
     std::chrono::steady_clock::time_point last_update;
+    uint32_t poll_interval_ms = 10000;
     
     // Internal state tracking (since iOS doesn't expose status reliably)
     bool internal_playing_state = false;
     std::chrono::steady_clock::time_point last_command_time;
     
+    // REST call statistics
+    LatencyHistogram rest_latency;
+    std::atomic<uint64_t> rest_failures{0};
+    
     // Configuration
     bool dsp_rest_api_available = false;
     bool bluetooth_available = false;
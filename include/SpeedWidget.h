@@ -0,0 +1,49 @@
+#ifndef SPEED_WIDGET_H
+#define SPEED_WIDGET_H
+
+#include "lvgl.h"
+#include <cstdint>
+#include <vector>
+
+// Speed readout drawn from a pre-rasterized digit atlas.
+//
+// The ten digits are rendered once at startup, each centred in a cell of
+// the widest digit's width, and kept as one A8 strip (about 20 KB at 48 px).
+// Drawing the speed is then up to three image blits, recoloured with the
+// label's text colour - no text layout, no glyph lookup, no kerning. Only
+// the cells whose digit changed are invalidated, so 57 -> 58 redraws one
+// glyph-sized area instead of the whole label. The cells are fixed width,
+// so the number no longer shifts sideways as digits change.
+class SpeedWidget {
+public:
+    static constexpr int MAX_DIGITS = 3;
+
+    // Takes over the label's place, font and colour and hides it
+    void attach(lv_obj_t* label);
+
+    // Negative values show nothing; above 999 clamps
+    void setValue(int speed);
+
+    lv_obj_t* getObject() const { return obj; }
+
+private:
+    static void drawEvent(lv_event_t* e);
+
+    void rasterize(const lv_font_t* font);
+    // Absolute area of the i-th shown digit
+    void cellArea(int index, lv_area_t& area) const;
+
+    lv_obj_t* obj = nullptr;
+    lv_color_t color;
+    int32_t cell_w = 0;
+    int32_t cell_h = 0;
+
+    std::vector<uint8_t> atlas;              // Digit d at rows [d * cell_h, (d + 1) * cell_h)
+    lv_image_dsc_t digit_images[10];
+
+    // Shown digits, left to right, centred in the widget
+    int shown[MAX_DIGITS] = {0, 0, 0};
+    int shown_count = 0;
+};
+
+#endif // SPEED_WIDGET_H
@@ -0,0 +1,56 @@
+#ifndef STATIC_LAYER_CACHE_H
+#define STATIC_LAYER_CACHE_H
+
+#include "lvgl.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Pre-composited background for a screen.
+//
+// The children EEZ creates without a name (the car silhouette, the
+// "km/h" / "ODO" / "TRIP" captions) are never touched by code. They are
+// drawn once, together with the screen background, into a snapshot that
+// becomes the screen's background image, and then hidden - so redrawing
+// any dirty area costs one image copy plus the dynamic widgets on top,
+// instead of re-blending every layer underneath.
+//
+// A child is only flattened when no dynamic sibling below it overlaps it
+// (z-order would change otherwise) and it takes no input. The snapshot is
+// rebuilt on the next LVGL tick after the screen's style (theme), size or
+// children change. Costs one screen-sized buffer (2.4 MB at 32-bit,
+// 1.2 MB in the RGB565 profile).
+class StaticLayerCache {
+public:
+    // Call right after the screen is created: its children at this point
+    // are the candidates; `named` lists the objects code refers to
+    void attach(lv_obj_t* screen, lv_obj_t* const* named, size_t named_count);
+
+    // Snapshot now
+    void rebuild();
+
+    // Rebuild on the next timer run
+    void invalidate();
+
+    size_t getFlattenedCount() const { return flattened.size(); }
+
+private:
+    static void screenEvent(lv_event_t* e);
+    static void rebuildAsync(void* user_data);
+
+    bool isNamed(lv_obj_t* obj) const;
+    void restore();
+
+    lv_obj_t* screen = nullptr;
+    std::vector<lv_obj_t*> named;
+    std::vector<lv_obj_t*> candidates;
+    std::vector<lv_obj_t*> flattened;     // Hidden, drawn from the snapshot
+
+    std::vector<uint8_t> buffer;
+    lv_image_dsc_t snapshot;
+    bool has_snapshot = false;
+    bool rebuilding = false;
+    bool pending = false;
+};
+
+#endif // STATIC_LAYER_CACHE_H
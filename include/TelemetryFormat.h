@@ -0,0 +1,119 @@
+#ifndef TELEMETRY_FORMAT_H
+#define TELEMETRY_FORMAT_H
+
+#include "SerialProtocol.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Binary telemetry log (.tzl) shared by the dashboard logger and offline tools.
+//
+// File:   TelemetryFileHeader, then chunks back to back
+// Chunk:  TelemetryChunkHeader + payload. Chunks decode independently -
+//         the delta state resets at every chunk start.
+// Record: varint (mask << 1 | type), then one zigzag varint per field
+//         whose bit is set in mask.
+//
+// Fields are quantized to fixed point (see TelemetryFormat.cpp for the
+// resolutions) and stored as the difference to a prediction - the previous
+// value, or for the ESP32 timestamp the previous value plus the previous
+// step. Unchanged fields cost nothing but their cleared mask bit. The
+// receive time is predicted from the sender clock and only stored when it
+// is off by more than 20ms, so it decodes to within that tolerance.
+//
+// A sidecar "<log>.idx" holds one TelemetryIndexEntry per chunk so tools
+// can seek by time without touching the payloads.
+
+#define TELEMETRY_FILE_MAGIC    0x4C545A54u  // "TZTL"
+#define TELEMETRY_CHUNK_MAGIC   0x43545A54u  // "TZTC"
+#define TELEMETRY_VERSION       1
+
+enum TelemetryType : uint8_t {
+    TELEMETRY_BMS = 0,
+    TELEMETRY_AUTOMOTIVE = 1,
+};
+
+struct TelemetryFileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;
+    int64_t created_ms;        // Unix milliseconds
+};
+static_assert(sizeof(TelemetryFileHeader) == 16, "TelemetryFileHeader layout changed");
+
+struct TelemetryChunkHeader {
+    uint32_t magic;
+    uint32_t payload_size;
+    uint32_t record_count;
+    uint32_t payload_crc;      // CRC-32 of the payload
+    int64_t first_time_ms;     // Unix milliseconds of the first/last record
+    int64_t last_time_ms;
+};
+static_assert(sizeof(TelemetryChunkHeader) == 32, "TelemetryChunkHeader layout changed");
+
+struct TelemetryIndexEntry {
+    int64_t first_time_ms;
+    int64_t last_time_ms;
+    uint64_t offset;           // Of the chunk header in the log file
+};
+static_assert(sizeof(TelemetryIndexEntry) == 24, "TelemetryIndexEntry layout changed");
+
+// One decoded packet with its receive time
+struct TelemetrySample {
+    TelemetryType type = TELEMETRY_BMS;
+    int64_t time_ms = 0;
+    bms_data_t bms = {};               // Valid when type == TELEMETRY_BMS
+    automotive_data_t automotive = {}; // Valid when type == TELEMETRY_AUTOMOTIVE
+};
+
+// Per-type prediction state, shared by encoder and decoder
+struct TelemetryFieldState {
+    static constexpr int MAX_FIELDS = 9;
+    int64_t value[MAX_FIELDS] = {0};
+    int64_t step[MAX_FIELDS] = {0};
+    bool seen = false;
+};
+
+// Builds one chunk in memory
+class TelemetryChunkEncoder {
+public:
+    void reset();
+    void add(const TelemetrySample& sample);
+
+    bool isEmpty() const { return record_count == 0; }
+    size_t getPayloadSize() const { return payload.size(); }
+    uint32_t getRecordCount() const { return record_count; }
+    int64_t getFirstTimeMs() const { return first_time_ms; }
+
+    // Chunk header + payload, ready to append to a log file
+    void finish(std::vector<uint8_t>& out) const;
+
+private:
+    std::vector<uint8_t> payload;
+    uint32_t record_count = 0;
+    int64_t first_time_ms = 0;
+    int64_t last_time_ms = 0;
+    TelemetryFieldState state[2];
+};
+
+// Read side - works directly on a mapped or loaded file
+class TelemetryReader {
+public:
+    using ChunkCallback = std::function<bool(const TelemetryChunkHeader& header, const uint8_t* payload, size_t offset)>;
+    using SampleCallback = std::function<void(const TelemetrySample& sample)>;
+
+    // Walk all valid chunks; stops at the first torn/corrupt chunk or when
+    // the callback returns false. Returns false if the file header is bad.
+    // With verify_crc = false only the headers are checked - callers then
+    // verifyChunk() themselves, e.g. in parallel.
+    static bool forEachChunk(const uint8_t* data, size_t size, const ChunkCallback& callback,
+                             bool verify_crc = true);
+    static bool verifyChunk(const TelemetryChunkHeader& header, const uint8_t* payload);
+
+    // Decode one chunk payload; false if it is malformed
+    static bool decodeChunk(const TelemetryChunkHeader& header, const uint8_t* payload,
+                            const SampleCallback& callback);
+};
+
+#endif // TELEMETRY_FORMAT_H
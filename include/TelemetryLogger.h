@@ -0,0 +1,75 @@
+#ifndef TELEMETRY_LOGGER_H
+#define TELEMETRY_LOGGER_H
+
+#include "TelemetryFormat.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct TelemetryLoggerConfig {
+    std::string directory;                              // Empty = dataDirectory()/telemetry
+    size_t max_file_bytes = 32 * 1024 * 1024;           // Rotate after this much
+    int max_files = 30;                                 // Oldest logs are deleted beyond this
+    size_t chunk_bytes = 16 * 1024;                     // Encoded payload per chunk
+    std::chrono::milliseconds chunk_interval{5000};     // Max data lost on a power cut
+    size_t max_queued = 8192;                           // Samples; excess is dropped
+};
+
+// Records every decoded serial packet to rotating .tzl files.
+//
+// logBMS()/logAutomotive() only append the raw struct to a queue under a
+// mutex. The worker thread wakes a few times per second, swaps the queue
+// out, encodes it (TelemetryFormat) and writes whole chunks, so the UI
+// thread never touches the SD card or the encoder.
+class TelemetryLogger {
+public:
+    explicit TelemetryLogger(TelemetryLoggerConfig config = TelemetryLoggerConfig());
+    ~TelemetryLogger();
+
+    bool start();
+    void stop();
+
+    void logBMS(const bms_data_t& data);
+    void logAutomotive(const automotive_data_t& data);
+
+    // Statistics for the metrics exporter
+    uint64_t getRecords() const { return records.load(std::memory_order_relaxed); }
+    uint64_t getRawBytes() const { return raw_bytes.load(std::memory_order_relaxed); }
+    uint64_t getWrittenBytes() const { return written_bytes.load(std::memory_order_relaxed); }
+    uint64_t getDropped() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    void push(const TelemetrySample& sample);
+    void workerLoop();
+    void writeChunk();
+    bool openNextFile();
+    void closeFile();
+    void pruneOldFiles();
+
+    TelemetryLoggerConfig config;
+
+    std::thread worker_thread;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool running = false;
+    std::vector<TelemetrySample> queue;
+
+    // Worker thread only
+    TelemetryChunkEncoder encoder;
+    std::chrono::steady_clock::time_point chunk_started;
+    std::vector<uint8_t> chunk_buffer;
+    int log_fd = -1;
+    int index_fd = -1;
+    size_t file_bytes = 0;
+
+    std::atomic<uint64_t> records{0};
+    std::atomic<uint64_t> raw_bytes{0};
+    std::atomic<uint64_t> written_bytes{0};
+    std::atomic<uint64_t> dropped{0};
+};
+
+#endif // TELEMETRY_LOGGER_H
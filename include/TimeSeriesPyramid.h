@@ -0,0 +1,69 @@
+#ifndef TIME_SERIES_PYRAMID_H
+#define TIME_SERIES_PYRAMID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum HistoryChannel {
+    HISTORY_VOLTAGE = 0,    // Pack V
+    HISTORY_CURRENT,        // A, negative while discharging
+    HISTORY_POWER,          // kW, positive while discharging
+    HISTORY_SOC,            // %
+    HISTORY_TEMP_MIN,       // C
+    HISTORY_TEMP_MAX,
+    HISTORY_CHANNELS
+};
+
+struct HistoryBucket {
+    int64_t index = -1;     // Bucket start / bucket duration
+    float min = 0.0f;
+    float max = 0.0f;
+    float sum = 0.0f;
+    uint32_t count = 0;     // 0 = no samples in this interval
+
+    float mean() const { return count ? sum / count : 0.0f; }
+};
+
+// Min/max/mean history of the BMS signals at 1 s, 10 s, 1 min and 10 min.
+//
+// Every sample is merged into the open bucket of each level, so appends are
+// O(1) and each level is exact rather than derived from the one below. Each
+// level is a fixed ring allocated up front (10 min of 1 s buckets, 1 h of
+// 10 s, 4 h of 1 min, 24 h of 10 min - about 190 KB for all channels);
+// intervals without samples take no space. A chart window is read from the
+// coarsest level that still gives it enough points, never from raw samples.
+class TimeSeriesPyramid {
+public:
+    static constexpr size_t LEVELS = 4;
+    static const uint32_t LEVEL_MS[LEVELS];
+    static const size_t LEVEL_CAPACITY[LEVELS];
+
+    TimeSeriesPyramid();
+
+    // time_ms: monotonic, e.g. ms since startup
+    void add(HistoryChannel channel, float value, uint64_t time_ms);
+
+    // Finest level with at most max_points buckets across the window that
+    // still holds the whole window
+    size_t levelFor(uint64_t window_ms, size_t max_points) const;
+
+    // The `points` buckets of `level` ending with the one containing now_ms,
+    // oldest first; intervals without samples come back with count 0
+    void read(HistoryChannel channel, size_t level, uint64_t now_ms, size_t points, HistoryBucket* out) const;
+
+    // Index of the bucket now_ms falls into - changes when a chart at this
+    // level needs a new point
+    static int64_t bucketIndex(size_t level, uint64_t time_ms) { return (int64_t)(time_ms / LEVEL_MS[level]); }
+
+private:
+    struct Ring {
+        std::vector<HistoryBucket> buckets;
+        size_t newest = 0;
+        size_t used = 0;
+    };
+
+    Ring rings[HISTORY_CHANNELS][LEVELS];
+};
+
+#endif // TIME_SERIES_PYRAMID_H
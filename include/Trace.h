@@ -0,0 +1,84 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Lightweight span tracing with Chrome trace JSON export
+// (open the dump in chrome://tracing or https://ui.perfetto.dev).
+//
+// Every thread records into its own fixed-size ring buffer, so recording
+// never takes a lock. When built without ENABLE_TRACING the macros compile
+// to nothing; when built with it but not enabled at runtime each span costs
+// one relaxed atomic load.
+//
+// Event names must be string literals (only the pointer is stored).
+
+struct TraceEvent {
+    const char* name;
+    uint64_t ts_us;     // Start time, us since trace epoch
+    uint64_t dur_us;    // Duration for complete ('X') events
+    char phase;         // 'X' complete, 'B' begin, 'E' end
+};
+
+class Trace {
+public:
+    // Runtime switch - also enabled by TAZZARI_TRACE=1 in the environment
+    static void setEnabled(bool on);
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+    static void initFromEnvironment();
+
+    // Name shown for the calling thread in the trace viewer; does not
+    // allocate until the thread records its first event
+    static void setThreadName(const char* name);
+
+    static uint64_t nowUs();
+    static void complete(const char* name, uint64_t start_us);
+    static void begin(const char* name);
+    static void end(const char* name);
+
+    // Dump request via signal (handler only sets a flag, the UI loop writes the file)
+    static void installDumpSignal(int signal_number);
+    static bool takeDumpRequest();
+
+    // Write all buffered events as Chrome trace JSON
+    static bool dumpChromeJson(const std::string& path);
+
+private:
+    static void record(const char* name, char phase, uint64_t ts_us, uint64_t dur_us);
+
+    static std::atomic<bool> enabled;
+};
+
+class TraceScope {
+public:
+    explicit TraceScope(const char* span_name)
+        : name(span_name), start_us(Trace::isEnabled() ? Trace::nowUs() : 0) {}
+
+    ~TraceScope() {
+        if (start_us) Trace::complete(name, start_us);
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name;
+    uint64_t start_us;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef ENABLE_TRACING
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#define TRACE_BEGIN(name) do { if (Trace::isEnabled()) Trace::begin(name); } while (0)
+#define TRACE_END(name)   do { if (Trace::isEnabled()) Trace::end(name); } while (0)
+#else
+#define TRACE_SCOPE(name) do {} while (0)
+#define TRACE_BEGIN(name) do {} while (0)
+#define TRACE_END(name)   do {} while (0)
+#endif
+
+#endif // TRACE_H
@@ -0,0 +1,128 @@
+#ifndef TRIP_HISTORY_H
+#define TRIP_HISTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// One closed trip
+struct TripRecord {
+    int64_t start_time = 0;        // Unix seconds
+    int64_t end_time = 0;
+    float distance_km = 0.0f;
+    float energy_used_wh = 0.0f;   // Discharge
+    float energy_regen_wh = 0.0f;  // Charge while driving
+    float soc_min = 100.0f;
+    float soc_max = 0.0f;
+    float speed_avg_kmh = 0.0f;    // Over moving time
+    float speed_max_kmh = 0.0f;
+    float temp_min_c = 0.0f;       // Battery temperature extremes
+    float temp_max_c = 0.0f;
+};
+
+// Aggregate over a time range
+struct TripSummary {
+    size_t trips = 0;
+    double distance_km = 0.0;
+    double energy_used_wh = 0.0;
+    double energy_regen_wh = 0.0;
+    double driving_hours = 0.0;
+    float speed_max_kmh = 0.0f;
+    float temp_max_c = -1000.0f;
+
+    double whPerKm() const {
+        return distance_km > 0.0 ? (energy_used_wh - energy_regen_wh) / distance_km : 0.0;
+    }
+};
+
+// Builds a TripRecord from live data between trip start and close
+class TripAccumulator {
+public:
+    bool isActive() const { return active; }
+
+    void start(int64_t now);
+    void addDistance(double km, double moving_hours);
+    void addSpeed(float speed_kmh);
+    void addEnergy(double used_wh, double regen_wh);
+    void addBattery(float soc, float temp_min, float temp_max);
+
+    // Finish the trip; returns false if nothing worth recording happened
+    bool close(int64_t now, TripRecord& out);
+
+private:
+    bool active = false;
+    bool battery_seen = false;
+    TripRecord record;
+    double distance_km = 0.0;
+    double moving_hours = 0.0;
+    double used_wh = 0.0;
+    double regen_wh = 0.0;
+};
+
+// Append-only columnar trip database.
+//
+// The file is a header followed by fixed-size blocks of BLOCK_CAPACITY
+// trips. Inside a block every field is stored as its own contiguous
+// column, so an aggregate touches only the columns it needs. Appends
+// write the column values first and bump the block's record count last
+// (the commit point), so a torn append is simply not counted. A new block
+// torn before its header was written is repaired by open().
+//
+// Queries memory-map the file read-only - nothing is copied into the heap.
+// append() is meant for a single writer thread (the persistence worker);
+// queries run on the UI thread.
+class TripHistory {
+public:
+    static constexpr uint32_t BLOCK_CAPACITY = 1024;
+
+    explicit TripHistory(const std::string& path = defaultPath());
+    ~TripHistory();
+
+    bool open();
+    void close();
+
+    bool append(const TripRecord& trip);
+
+    // Query side - remaps automatically when the writer has grown the file
+    size_t getTripCount();
+    bool getTrip(size_t index, TripRecord& out);
+    TripSummary aggregate(int64_t from_time, int64_t to_time);
+
+    static std::string defaultPath();
+
+private:
+    // Column order inside a block (int64 columns first, then float columns)
+    enum Column {
+        COL_START_TIME, COL_END_TIME,
+        COL_DISTANCE, COL_ENERGY_USED, COL_ENERGY_REGEN,
+        COL_SOC_MIN, COL_SOC_MAX, COL_SPEED_AVG, COL_SPEED_MAX,
+        COL_TEMP_MIN, COL_TEMP_MAX,
+        COLUMN_COUNT
+    };
+
+    static size_t columnWidth(int column);
+    static size_t columnOffset(int column);
+    static size_t blockSize();
+    static size_t blockOffset(size_t block);
+
+    // Read the tail block's count; restore its header if a crash hit
+    // between preallocating the block and writing it
+    bool recoverTailBlock();
+
+    bool refreshMapping();
+    uint32_t blockCount(const uint8_t* base, size_t block) const;
+
+    std::string path;
+
+    // Writer state
+    int write_fd = -1;
+    size_t write_blocks = 0;
+    uint32_t write_tail_count = 0;   // Records in the last block
+
+    // Reader state
+    int read_fd = -1;
+    const uint8_t* map_base = nullptr;
+    size_t map_size = 0;
+};
+
+#endif // TRIP_HISTORY_H
@@ -0,0 +1,32 @@
+#ifndef TRIP_SCREEN_H
+#define TRIP_SCREEN_H
+
+#include "ScreenManager.h"
+#include "TripHistory.h"
+
+// Trip computer: totals for today, the last 7 and 30 days and all time,
+// and the most recent trips. Everything comes from the trip database's
+// column aggregates; the text is only rebuilt when a trip has been added
+// or the day has changed.
+class TripScreen : public LazyScreen {
+public:
+    static constexpr size_t RECENT_TRIPS = 10;
+
+    explicit TripScreen(TripHistory& history);
+
+    const char* getName() const override { return "trips"; }
+    lv_obj_t* build() override;
+    void release() override;
+    void tick(uint64_t now_ms) override;
+
+private:
+    void refresh();
+
+    TripHistory& history;
+    lv_obj_t* lbl_totals = nullptr;
+    lv_obj_t* lbl_recent = nullptr;
+    size_t shown_trips = SIZE_MAX;
+    int64_t shown_day = -1;
+};
+
+#endif // TRIP_SCREEN_H
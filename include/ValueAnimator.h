@@ -0,0 +1,65 @@
+#ifndef VALUE_ANIMATOR_H
+#define VALUE_ANIMATOR_H
+
+#include "lvgl.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Frame-paced interpolation of displayed values between samples.
+//
+// Each channel glides from where it is on screen to a new target over the
+// time the previous target took to arrive, so with the 100 ms display
+// tick the value is always one sample behind and moves every frame instead
+// of stepping ten times a second. One lv_timer at the display refresh
+// period drives all channels and pauses as soon as every channel has
+// arrived - a stable dashboard costs no wakeups. A target equal to the
+// current one does not restart anything. The apply callback receives the
+// in-between value; it should round to what the widget shows and skip
+// unchanged values, so only widgets whose output moves are invalidated.
+class ValueAnimator {
+public:
+    using ApplyFn = std::function<void(float)>;
+
+    static constexpr uint32_t MIN_DURATION_MS = LV_DEF_REFR_PERIOD;
+    static constexpr uint32_t MAX_DURATION_MS = 500;   // Longer gaps (link drops) snap sooner
+
+    ValueAnimator() = default;
+    ~ValueAnimator();
+    ValueAnimator(const ValueAnimator&) = delete;
+    ValueAnimator& operator=(const ValueAnimator&) = delete;
+
+    // Returns the channel id
+    size_t add(ApplyFn apply);
+
+    void setTarget(size_t channel, float target);
+
+    // Forget the channel; the next target is shown without a glide
+    void reset(size_t channel);
+
+    float getValue(size_t channel) const { return channels[channel].current; }
+    bool isRunning() const { return timer && !paused; }
+
+private:
+    struct Channel {
+        ApplyFn apply;
+        bool has_value = false;
+        bool active = false;
+        float from = 0.0f;
+        float to = 0.0f;
+        float current = 0.0f;
+        uint32_t start_ms = 0;
+        uint32_t duration_ms = 0;
+        uint32_t last_target_ms = 0;
+    };
+
+    static void timerCallback(lv_timer_t* timer);
+    void step();
+
+    std::vector<Channel> channels;
+    lv_timer_t* timer = nullptr;
+    bool paused = true;
+};
+
+#endif // VALUE_ANIMATOR_H
@@ -1,16 +1,35 @@
 #ifndef LV_CONF_H
 #define LV_CONF_H
 
-#define LV_COLOR_DEPTH 32
+// -DCOLOR_DEPTH_16=ON renders in RGB565 (see SdlDisplay.h)
+#ifdef COLOR_DEPTH_16
+    #define LV_COLOR_DEPTH 16
+#else
+    #define LV_COLOR_DEPTH 32
+#endif
 #define LV_COLOR_CHROMA_KEY lv_color_hex(0x00ff00)
 
 // Memory settings
 #define LV_MEM_SIZE (256 * 1024U)  // 256KB for Ubuntu
 
+// No image cache: UI images are RGB565 / RGB565A8 (tools/convert_ui_image.py)
+// and drawn straight from flash, so nothing is decoded into the heap above
+#define LV_CACHE_DEF_SIZE 0
+
 // Display settings
 #define LV_DPI_DEF 100
-#define LV_USE_PERF_MONITOR 1
-#define LV_USE_MEM_MONITOR 1
+// 60 fps; frames are only rendered when something is dirty
+#define LV_DEF_REFR_PERIOD 16
+
+// On-screen overlays for development only - deployment builds export the
+// same numbers through the metrics endpoint instead
+#ifdef DEPLOYMENT_BUILD
+    #define LV_USE_PERF_MONITOR 0
+    #define LV_USE_MEM_MONITOR 0
+#else
+    #define LV_USE_PERF_MONITOR 1
+    #define LV_USE_MEM_MONITOR 1
+#endif
 
 // Enable features your UI uses
 #define LV_USE_LABEL 1
@@ -24,24 +43,26 @@
 
 // File system (for images/assets)
 #define LV_USE_FS_STDIO 1
+#define LV_FS_STDIO_LETTER 'A'   // "A:img/splash.png" - relative to working dir
 
-// Enable SDL2 driver
-#define LV_USE_SDL 1
+// PNG decoder for the boot splash
+#define LV_USE_LODEPNG 1
 
-// SDL2 Configuration - conditional based on build type
-#ifdef DEPLOYMENT_BUILD
-    #define LV_SDL_RESOLUTION_H 0    // 0 = use desktop resolution
-    #define LV_SDL_RESOLUTION_V 0    // 0 = use desktop resolution
-    #define LV_SDL_FULLSCREEN 1      // Enable fullscreen
-    #define LV_SDL_DIRECT_EXIT 1     // Exit on window close
-    #define LV_SDL_MOUSE_CURSOR 0    // Hide mouse cursor
+// Static background layer (src/StaticLayerCache.cpp)
+#define LV_USE_SNAPSHOT 1
+
+// Window, flush and input come from SdlDisplay (src/SdlDisplay.cpp), which
+// sets up the draw buffers at runtime - LVGL's own SDL driver is not used
+#define LV_USE_SDL 0
+
+// Software rendering split across LVGL_DRAW_UNITS threads (CMake cache)
+#define LV_USE_DRAW_SW 1
+#ifdef LVGL_DRAW_UNITS
+    #define LV_DRAW_SW_DRAW_UNIT_CNT LVGL_DRAW_UNITS
 #else
-    #define LV_SDL_RESOLUTION_H 1024 // Fixed window size for development
-    #define LV_SDL_RESOLUTION_V 600
-    #define LV_SDL_FULLSCREEN 0      // Windowed mode
-    #define LV_SDL_DIRECT_EXIT 1     // Exit on window close
-    #define LV_SDL_MOUSE_CURSOR 1    // Show mouse cursor for development
+    #define LV_DRAW_SW_DRAW_UNIT_CNT 1
 #endif
+
 // Logging
 #define LV_USE_LOG 1
 #define LV_LOG_LEVEL LV_LOG_LEVEL_INFO
@@ -70,6 +91,12 @@
 #define LV_FONT_MONTSERRAT_42 0
 #define LV_FONT_MONTSERRAT_44 0
 #define LV_FONT_MONTSERRAT_46 0
-#define LV_FONT_MONTSERRAT_48 1  // Enable 48pt
+#ifdef SUBSET_FONTS
+    // Digits, "DNR" and "-" only - generated by the build, see CMakeLists.txt
+    #define LV_FONT_MONTSERRAT_48 0
+    #define LV_FONT_CUSTOM_DECLARE LV_FONT_DECLARE(lv_font_montserrat_48)
+#else
+    #define LV_FONT_MONTSERRAT_48 1  // Enable 48pt
+#endif
 
 #endif
@@ -0,0 +1,243 @@
+#include "AssetPack.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define ASSET_PACK_MAGIC    0x50415A54u  // "TZAP"
+#define ASSET_PACK_VERSION  1
+
+// Layout written by tools/pack_ui_assets.py
+struct AssetPackHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t entry_count;
+    uint32_t index_offset;
+};
+
+struct AssetPackEntry {
+    char name[40];
+    uint8_t kind;
+    uint8_t format;
+    uint16_t w;
+    uint16_t h;
+    uint16_t stride;
+    uint32_t offset;
+    uint32_t size;
+};
+
+static const size_t ENTRY_SIZE = 64;
+static const uint8_t KIND_IMAGE = 0;
+
+AssetPack* AssetPack::registered = nullptr;
+
+// What a stub without pack data decodes to
+static const uint32_t TRANSPARENT_PIXEL = 0;
+
+static lv_image_header_t transparentHeader() {
+    lv_image_header_t header;
+    memset(&header, 0, sizeof(header));
+    header.magic = LV_IMAGE_HEADER_MAGIC;
+    header.cf = LV_COLOR_FORMAT_ARGB8888;
+    header.w = 1;
+    header.h = 1;
+    header.stride = sizeof(TRANSPARENT_PIXEL);
+    return header;
+}
+
+// Pack format code -> LVGL format and bytes per pixel in the alpha plane
+static bool colorFormatFor(uint8_t format, lv_color_format_t& cf, uint32_t& alpha_bytes) {
+    switch (format) {
+        case 1: cf = LV_COLOR_FORMAT_RGB565;   alpha_bytes = 0; return true;
+        case 2: cf = LV_COLOR_FORMAT_RGB565A8; alpha_bytes = 1; return true;
+        case 3: cf = LV_COLOR_FORMAT_ARGB8888; alpha_bytes = 0; return true;
+        default: return false;
+    }
+}
+
+AssetPack::~AssetPack() {
+    // The decoder stays registered with LVGL; without a pack it draws every
+    // stub transparent
+    if (registered == this) {
+        registered = nullptr;
+    }
+    close();
+}
+
+std::string AssetPack::defaultPath() {
+    if (const char* env = std::getenv("TAZZARI_ASSET_PACK")) {
+        return env;
+    }
+    char exe[4096];
+    ssize_t len = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+    if (len <= 0) return "tazzari.assets";
+    std::string dir(exe, len);
+    return dir.substr(0, dir.find_last_of('/') + 1) + "tazzari.assets";
+}
+
+bool AssetPack::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "AssetPack: Cannot open " << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(AssetPackHeader)) {
+        std::cerr << "AssetPack: " << path << " is too short" << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    // The mapping outlives the descriptor
+    void* mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "AssetPack: mmap failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+    map_base = (const uint8_t*)mapped;
+    map_size = st.st_size;
+
+    // Fault in only what is drawn - no readahead of neighbouring images
+    madvise(mapped, map_size, MADV_RANDOM);
+
+    AssetPackHeader header;
+    memcpy(&header, map_base, sizeof(header));
+    if (header.magic != ASSET_PACK_MAGIC || header.version != ASSET_PACK_VERSION ||
+        header.index_offset + (size_t)header.entry_count * ENTRY_SIZE > map_size) {
+        std::cerr << "AssetPack: " << path << " is not a version " << ASSET_PACK_VERSION << " asset pack" << std::endl;
+        close();
+        return false;
+    }
+
+    for (uint16_t i = 0; i < header.entry_count; i++) {
+        AssetPackEntry entry;
+        memcpy(&entry, map_base + header.index_offset + i * ENTRY_SIZE, sizeof(entry));
+        entry.name[sizeof(entry.name) - 1] = '\0';
+        if (entry.kind != KIND_IMAGE) continue;    // Fonts later
+
+        lv_color_format_t cf;
+        uint32_t alpha_bytes;
+        uint64_t expected = (uint64_t)entry.stride * entry.h;
+        if (!colorFormatFor(entry.format, cf, alpha_bytes) ||
+            entry.size < expected + (uint64_t)entry.w * entry.h * alpha_bytes ||
+            (uint64_t)entry.offset + entry.size > map_size) {
+            std::cerr << "AssetPack: Skipping damaged entry " << entry.name << std::endl;
+            continue;
+        }
+
+        AssetImage image;
+        image.name = entry.name;
+        memset(&image.header, 0, sizeof(image.header));
+        image.header.magic = LV_IMAGE_HEADER_MAGIC;
+        image.header.cf = cf;
+        image.header.w = entry.w;
+        image.header.h = entry.h;
+        image.header.stride = entry.stride;
+        image.data = map_base + entry.offset;
+        image.size = entry.size;
+        images.push_back(image);
+    }
+
+    std::sort(images.begin(), images.end(),
+              [](const AssetImage& a, const AssetImage& b) { return a.name < b.name; });
+
+    std::cout << "AssetPack: Mapped " << images.size() << " images (" << map_size / 1024 << " KB) from "
+              << path << std::endl;
+    return true;
+}
+
+void AssetPack::close() {
+    images.clear();
+    if (map_base) {
+        munmap((void*)map_base, map_size);
+        map_base = nullptr;
+        map_size = 0;
+    }
+}
+
+const AssetImage* AssetPack::findImage(const char* name) const {
+    auto it = std::lower_bound(images.begin(), images.end(), name,
+                               [](const AssetImage& image, const char* key) { return image.name < key; });
+    if (it == images.end() || it->name != name) return nullptr;
+    return &*it;
+}
+
+bool AssetPack::isStub(const void* src) {
+    if (lv_image_src_get_type(src) != LV_IMAGE_SRC_VARIABLE) return false;
+    const lv_image_dsc_t* stub = (const lv_image_dsc_t*)src;
+    return (stub->header.flags & ASSET_PACK_IMAGE_FLAG) && stub->data;
+}
+
+const AssetImage* AssetPack::imageForSource(const void* src) const {
+    if (!isStub(src)) return nullptr;
+    return findImage((const char*)((const lv_image_dsc_t*)src)->data);
+}
+
+void AssetPack::reportMissing(const void* src) {
+    const char* name = (const char*)((const lv_image_dsc_t*)src)->data;
+    // Draw units can decode concurrently
+    static std::mutex reported_mutex;
+    static std::set<std::string> reported;
+    std::lock_guard<std::mutex> lock(reported_mutex);
+    if (reported.insert(name).second) {
+        std::cerr << "AssetPack: " << name << " is not in the pack - drawing it transparent" << std::endl;
+    }
+}
+
+void AssetPack::registerDecoder() {
+    if (decoder) return;
+    registered = this;
+
+    // Newest decoder is asked first
+    decoder = lv_image_decoder_create();
+    lv_image_decoder_set_info_cb(decoder, decoderInfo);
+    lv_image_decoder_set_open_cb(decoder, decoderOpen);
+    lv_image_decoder_set_close_cb(decoder, decoderClose);
+}
+
+// Header from the pack, not the stub - artwork may have changed size. Every
+// stub is claimed, even one missing from the pack (or with no pack open):
+// returning INVALID would let the built-in decoder read its name as pixels,
+// so it decodes to a single transparent pixel instead.
+lv_result_t AssetPack::decoderInfo(lv_image_decoder_t* decoder, const void* src, lv_image_header_t* header) {
+    (void)decoder;
+    if (!isStub(src)) return LV_RESULT_INVALID;
+
+    const AssetImage* image = registered ? registered->imageForSource(src) : nullptr;
+    *header = image ? image->header : transparentHeader();
+    return LV_RESULT_OK;
+}
+
+lv_result_t AssetPack::decoderOpen(lv_image_decoder_t* decoder, lv_image_decoder_dsc_t* dsc,
+                                   const lv_image_decoder_args_t* args) {
+    (void)decoder;
+    (void)args;
+    if (!isStub(dsc->src)) return LV_RESULT_INVALID;
+
+    const AssetImage* image = registered ? registered->imageForSource(dsc->src) : nullptr;
+    if (image) {
+        dsc->header = image->header;
+        dsc->img_data = image->data;
+    } else {
+        reportMissing(dsc->src);
+        dsc->header = transparentHeader();
+        dsc->img_data = (const uint8_t*)&TRANSPARENT_PIXEL;
+    }
+    return LV_RESULT_OK;
+}
+
+// The pixels belong to the mapping
+void AssetPack::decoderClose(lv_image_decoder_t* decoder, lv_image_decoder_dsc_t* dsc) {
+    (void)decoder;
+    (void)dsc;
+}
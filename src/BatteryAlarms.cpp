@@ -0,0 +1,202 @@
+#include "BatteryAlarms.h"
+#include "DataPaths.h"
+#include "battery_alarms_builtin.h"   // BUILTIN_CONFIG: config/battery_alarms.conf
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+static const char* SIGNAL_NAMES[SIGNAL_COUNT] = {
+    "cell_max_v", "cell_min_v", "temp_max", "temp_min", "soc", "current", "cell_spread_mv"
+};
+
+static const char* SEVERITY_NAMES[] = {"none", "info", "warning", "critical"};
+
+static std::string trim(const std::string& s) {
+    size_t begin = s.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return "";
+    size_t end = s.find_last_not_of(" \t\r");
+    return s.substr(begin, end - begin + 1);
+}
+
+static bool parseSignal(const std::string& name, AlarmSignal& out) {
+    for (int i = 0; i < SIGNAL_COUNT; i++) {
+        if (name == SIGNAL_NAMES[i]) {
+            out = (AlarmSignal)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool parseSeverity(const std::string& name, AlarmSeverity& out) {
+    for (int i = ALARM_INFO; i <= ALARM_CRITICAL; i++) {
+        if (name == SEVERITY_NAMES[i]) {
+            out = (AlarmSeverity)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+BatteryAlarms::BatteryAlarms() {
+    loadText(BUILTIN_CONFIG, "built-in");
+}
+
+const char* BatteryAlarms::signalName(AlarmSignal signal) {
+    return signal < SIGNAL_COUNT ? SIGNAL_NAMES[signal] : "?";
+}
+
+const char* BatteryAlarms::severityName(AlarmSeverity severity) {
+    return severity <= ALARM_CRITICAL ? SEVERITY_NAMES[severity] : "?";
+}
+
+std::string BatteryAlarms::defaultConfigPath() {
+    if (const char* path = std::getenv("TAZZARI_ALARM_CONFIG")) {
+        return path;
+    }
+    return dataDirectory() + "/battery_alarms.conf";
+}
+
+bool BatteryAlarms::loadFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+    return loadText(text.str(), path);
+}
+
+bool BatteryAlarms::loadText(const std::string& text, const std::string& origin) {
+    std::string selected;
+    std::string section;
+    std::map<std::string, std::vector<AlarmRule>> sections;
+
+    std::istringstream lines(text);
+    std::string line;
+    int line_number = 0;
+    while (std::getline(lines, line)) {
+        line_number++;
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) continue;
+
+        if (line.front() == '[' && line.back() == ']') {
+            section = trim(line.substr(1, line.size() - 2));
+            sections[section];
+            continue;
+        }
+
+        size_t equals = line.find('=');
+        if (equals != std::string::npos) {
+            if (trim(line.substr(0, equals)) == "chemistry") {
+                selected = trim(line.substr(equals + 1));
+                continue;
+            }
+        }
+
+        std::istringstream fields(line);
+        std::string signal, severity, op;
+        AlarmRule rule;
+        if (section.empty() || !(fields >> signal >> severity >> op >> rule.set >> rule.clear >> rule.debounce_ms) ||
+            !parseSignal(signal, rule.signal) || !parseSeverity(severity, rule.severity) ||
+            (op != ">" && op != "<")) {
+            std::cerr << "Alarms: " << origin << ":" << line_number << ": cannot parse '" << line << "'" << std::endl;
+            return false;
+        }
+        rule.above = op == ">";
+
+        // A clear level on the wrong side of the set level would never clear
+        if (rule.above ? rule.clear > rule.set : rule.clear < rule.set) {
+            std::cerr << "Alarms: " << origin << ":" << line_number << ": clear level past set level" << std::endl;
+            return false;
+        }
+        sections[section].push_back(rule);
+    }
+
+    auto found = sections.find(selected);
+    if (found == sections.end()) {
+        std::cerr << "Alarms: " << origin << ": no section for chemistry '" << selected << "'" << std::endl;
+        return false;
+    }
+
+    chemistry = selected;
+    rules = found->second;
+    states.assign(rules.size(), RuleState());
+    severity = ALARM_NONE;
+    std::cout << "Alarms: " << rules.size() << " rules for " << chemistry << " (" << origin << ")" << std::endl;
+    return true;
+}
+
+bool BatteryAlarms::evaluate(const BatterySignals& signals, uint32_t now_ms) {
+    bool changed = false;
+
+    for (size_t i = 0; i < rules.size(); i++) {
+        const AlarmRule& rule = rules[i];
+        RuleState& state = states[i];
+        if (!signals.present[rule.signal]) continue;
+
+        // Condition for the next transition: crossing `set` while inactive,
+        // back past `clear` while active
+        float value = signals.value[rule.signal];
+        bool transition;
+        if (!state.active) {
+            transition = rule.above ? value > rule.set : value < rule.set;
+        } else {
+            transition = rule.above ? value < rule.clear : value > rule.clear;
+        }
+
+        if (!transition) {
+            state.pending = false;
+            continue;
+        }
+        if (!state.pending) {
+            state.pending = true;
+            state.pending_since = now_ms;
+        }
+        if (now_ms - state.pending_since >= rule.debounce_ms) {
+            state.active = !state.active;
+            state.pending = false;
+            record(i, state.active, value);
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        severity = ALARM_NONE;
+        for (size_t i = 0; i < rules.size(); i++) {
+            if (states[i].active) severity = std::max(severity, rules[i].severity);
+        }
+    }
+    return changed;
+}
+
+void BatteryAlarms::reset() {
+    for (RuleState& state : states) {
+        state = RuleState();
+    }
+    severity = ALARM_NONE;
+}
+
+void BatteryAlarms::record(size_t rule, bool raised, float value) {
+    AlarmEvent& event = history[(history_head + history_count) % HISTORY_SIZE];
+    event.time = time(nullptr);
+    event.rule = rule;
+    event.raised = raised;
+    event.value = value;
+    if (history_count < HISTORY_SIZE) {
+        history_count++;
+    } else {
+        history_head = (history_head + 1) % HISTORY_SIZE;
+    }
+
+    const AlarmRule& r = rules[rule];
+    std::cout << "Alarms: " << signalName(r.signal) << " " << severityName(r.severity)
+              << (raised ? " raised at " : " cleared at ") << value << std::endl;
+}
+
+const AlarmEvent& BatteryAlarms::getHistory(size_t index) const {
+    return history[(history_head + index) % HISTORY_SIZE];
+}
@@ -0,0 +1,160 @@
+#include "CellHeatmap.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+// Grid geometry on the 1024x600 panel
+static const int GRID_X = 11;
+static const int GRID_Y = 56;
+static const int TILE_W = 120;
+static const int TILE_H = 62;
+static const int TILE_GAP = 6;
+
+CellHeatmap::CellHeatmap(CellHeatmapConfig config) : config(config) {
+}
+
+void CellHeatmap::setSource(const cell_data_t* cells, const CellStatistics* stats) {
+    source_cells = cells;
+    source_stats = stats;
+}
+
+lv_obj_t* CellHeatmap::build() {
+    screen = lv_obj_create(NULL);
+    lv_obj_set_style_bg_color(screen, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_clear_flag(screen, LV_OBJ_FLAG_SCROLLABLE);
+
+    lbl_summary = lv_label_create(screen);
+    lv_obj_set_style_text_font(lbl_summary, &lv_font_montserrat_16, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_color(lbl_summary, lv_color_hex(0xffffff), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_pos(lbl_summary, GRID_X, 18);
+    lv_label_set_text(lbl_summary, "Waiting for cell data...");
+
+    for (int i = 0; i < MAX_CELLS; i++) {
+        Tile& tile = tiles[i];
+        tile.obj = lv_obj_create(screen);
+        lv_obj_set_pos(tile.obj, GRID_X + (i % COLUMNS) * (TILE_W + TILE_GAP),
+                       GRID_Y + (i / COLUMNS) * (TILE_H + TILE_GAP));
+        lv_obj_set_size(tile.obj, TILE_W, TILE_H);
+        lv_obj_clear_flag(tile.obj, LV_OBJ_FLAG_SCROLLABLE | LV_OBJ_FLAG_CLICKABLE);
+        lv_obj_set_style_radius(tile.obj, 4, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_border_width(tile.obj, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_border_color(tile.obj, lv_color_hex(0xffffff), LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_pad_all(tile.obj, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+        tile.label = lv_label_create(tile.obj);
+        lv_obj_set_style_text_font(tile.label, &lv_font_montserrat_16, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_text_color(tile.label, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_center(tile.label);
+        lv_label_set_text(tile.label, "");
+
+        lv_obj_add_flag(tile.obj, LV_OBJ_FLAG_HIDDEN);
+    }
+
+    lv_obj_add_event_cb(screen, [](lv_event_t* e) {
+        ((ScreenManager*)lv_event_get_user_data(e))->showHome();
+    }, LV_EVENT_CLICKED, manager);
+    return screen;
+}
+
+void CellHeatmap::release() {
+    screen = nullptr;
+    lbl_summary = nullptr;
+    for (Tile& tile : tiles) {
+        tile = Tile();
+    }
+    laid_out_cells = -1;
+    summary[0] = '\0';
+}
+
+// Tiles and summary only change when the shown values do
+void CellHeatmap::tick(uint64_t now_ms) {
+    (void)now_ms;
+    if (source_cells && source_stats) update(*source_cells, *source_stats);
+}
+
+void CellHeatmap::layout(int cell_count) {
+    for (int i = 0; i < MAX_CELLS; i++) {
+        Tile& tile = tiles[i];
+        tile.shown_mv = 0;
+        tile.bucket = -1;
+        setOutline(tile, false);
+        if (i < cell_count) {
+            lv_obj_clear_flag(tile.obj, LV_OBJ_FLAG_HIDDEN);
+        } else {
+            lv_obj_add_flag(tile.obj, LV_OBJ_FLAG_HIDDEN);
+        }
+    }
+    laid_out_cells = cell_count;
+}
+
+int CellHeatmap::colorBucket(uint16_t mv) const {
+    if (mv <= config.low_mv) return 0;
+    if (mv >= config.high_mv) return COLOR_BUCKETS - 1;
+    return (int)(mv - config.low_mv) * COLOR_BUCKETS / (config.high_mv - config.low_mv + 1);
+}
+
+void CellHeatmap::setOutline(Tile& tile, bool outlined) {
+    if (tile.outlined == outlined) return;
+    lv_obj_set_style_border_width(tile.obj, outlined ? 4 : 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+    tile.outlined = outlined;
+}
+
+void CellHeatmap::update(const cell_data_t& cells, const CellStatistics& stats) {
+    if (!screen) return;
+    if (stats.cell_count != laid_out_cells) {
+        layout(stats.cell_count);
+    }
+    if (stats.cell_count == 0) return;
+
+    int weak_index = stats.weakCellSagMv() >= config.weak_sag_mv ? stats.min_index : -1;
+
+    char text[8];
+    for (int i = 0; i < stats.cell_count; i++) {
+        Tile& tile = tiles[i];
+        uint16_t mv = cells.cell_mv[i];
+
+        bool faulted = mv > CellStats::MAX_CELL_MV;
+
+        if (mv != tile.shown_mv) {
+            if (faulted) {
+                lv_label_set_text(tile.label, "ERR");
+            } else {
+                snprintf(text, sizeof(text), "%u", mv);
+                lv_label_set_text(tile.label, text);
+            }
+            tile.shown_mv = mv;
+        }
+
+        int bucket = faulted ? FAULT_BUCKET : colorBucket(mv);
+        if (bucket != tile.bucket) {
+            // Red (low) through yellow to green (high); grey for a faulted sensor
+            lv_color_t color = faulted ? lv_color_hex(0x606060)
+                                       : lv_color_hsv_to_rgb((uint16_t)(bucket * 120 / (COLOR_BUCKETS - 1)), 80, 90);
+            lv_obj_set_style_bg_color(tile.obj, color, LV_PART_MAIN | LV_STATE_DEFAULT);
+            tile.bucket = bucket;
+        }
+
+        setOutline(tile, i == weak_index);
+    }
+
+    char line[sizeof(summary)];
+    if (stats.valid_count == 0) {
+        snprintf(line, sizeof(line), "%d cells   no valid reading", stats.cell_count);
+    } else if (stats.temp_count > 0) {
+        snprintf(line, sizeof(line), "%d cells   min %u (#%d)   max %u (#%d)   mean %.0f   spread %u   sd %.1f mV   %d..%d C",
+                 stats.cell_count, stats.min_mv, stats.min_index + 1, stats.max_mv, stats.max_index + 1,
+                 stats.mean_mv, stats.spread_mv, stats.imbalance_mv, stats.min_temp_c, stats.max_temp_c);
+    } else {
+        snprintf(line, sizeof(line), "%d cells   min %u (#%d)   max %u (#%d)   mean %.0f   spread %u   sd %.1f mV",
+                 stats.cell_count, stats.min_mv, stats.min_index + 1, stats.max_mv, stats.max_index + 1,
+                 stats.mean_mv, stats.spread_mv, stats.imbalance_mv);
+    }
+    if (stats.invalid_count > 0) {
+        size_t length = strlen(line);
+        snprintf(line + length, sizeof(line) - length, "   %d faulted", stats.invalid_count);
+    }
+    if (strcmp(line, summary) != 0) {
+        strcpy(summary, line);
+        lv_label_set_text(lbl_summary, summary);
+    }
+}
@@ -0,0 +1,209 @@
+#include "CellStats.h"
+#include <algorithm>
+#include <cmath>
+
+// -DCELL_STATS_SCALAR forces the scalar kernel (tools/cell_stats_check)
+#if defined(CELL_STATS_SCALAR)
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CELL_STATS_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define CELL_STATS_SSE2
+#endif
+
+namespace {
+
+struct Reduction {
+    uint16_t min_mv = UINT16_MAX;
+    uint16_t max_mv = 0;
+    uint32_t sum = 0;
+    uint32_t sum_squares = 0;
+    uint32_t valid = 0;        // Readings within MAX_CELL_MV
+};
+
+void reduceScalar(const uint16_t* cell_mv, size_t begin, size_t end, Reduction& r) {
+    for (size_t i = begin; i < end; i++) {
+        uint32_t mv = cell_mv[i];
+        if (mv > CellStats::MAX_CELL_MV) continue;
+        r.min_mv = std::min<uint16_t>(r.min_mv, mv);
+        r.max_mv = std::max<uint16_t>(r.max_mv, mv);
+        r.sum += mv;
+        r.sum_squares += mv * mv;
+        r.valid++;
+    }
+}
+
+#if defined(CELL_STATS_NEON)
+
+// Returns how many cells were handled; the rest go through reduceScalar
+size_t reduceVector(const uint16_t* cell_mv, size_t count, Reduction& r) {
+    size_t blocks = count / 8;
+    if (blocks == 0) return 0;
+
+    const uint16x8_t limit = vdupq_n_u16(CellStats::MAX_CELL_MV);
+    uint16x8_t vmin = vdupq_n_u16(UINT16_MAX);
+    uint16x8_t vmax = vdupq_n_u16(0);
+    uint32x4_t vsum = vdupq_n_u32(0);
+    uint32x4_t vsq = vdupq_n_u32(0);
+    uint16x8_t vcount = vdupq_n_u16(0);
+
+    for (size_t b = 0; b < blocks; b++) {
+        uint16x8_t raw = vld1q_u16(cell_mv + b * 8);
+        uint16x8_t valid = vcleq_u16(raw, limit);
+        // Out-of-range lanes: UINT16_MAX for the minimum, 0 everywhere else
+        vmin = vminq_u16(vmin, vorrq_u16(raw, vmvnq_u16(valid)));
+        uint16x8_t v = vandq_u16(raw, valid);
+        vmax = vmaxq_u16(vmax, v);
+        vcount = vsubq_u16(vcount, valid);   // Valid lanes are all ones (-1)
+        vsum = vpadalq_u16(vsum, v);
+        vsq = vmlal_u16(vsq, vget_low_u16(v), vget_low_u16(v));
+        vsq = vmlal_u16(vsq, vget_high_u16(v), vget_high_u16(v));
+    }
+
+    uint16_t lanes_min[8], lanes_max[8], lanes_count[8];
+    uint32_t lanes_sum[4], lanes_sq[4];
+    vst1q_u16(lanes_min, vmin);
+    vst1q_u16(lanes_max, vmax);
+    vst1q_u16(lanes_count, vcount);
+    vst1q_u32(lanes_sum, vsum);
+    vst1q_u32(lanes_sq, vsq);
+
+    for (int i = 0; i < 8; i++) {
+        r.min_mv = std::min(r.min_mv, lanes_min[i]);
+        r.max_mv = std::max(r.max_mv, lanes_max[i]);
+        r.valid += lanes_count[i];
+    }
+    for (int i = 0; i < 4; i++) {
+        r.sum += lanes_sum[i];
+        r.sum_squares += lanes_sq[i];
+    }
+    return blocks * 8;
+}
+
+#elif defined(CELL_STATS_SSE2)
+
+size_t reduceVector(const uint16_t* cell_mv, size_t count, Reduction& r) {
+    size_t blocks = count / 8;
+    if (blocks == 0) return 0;
+
+    // SSE2 only has signed 16-bit min/max; flipping the top bit maps
+    // unsigned order onto signed order
+    const __m128i bias = _mm_set1_epi16((short)0x8000);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i signed_max = _mm_set1_epi16(0x7FFF);
+    const __m128i biased_above_limit = _mm_set1_epi16((short)((CellStats::MAX_CELL_MV + 1) ^ 0x8000));
+    __m128i vmin = signed_max;
+    __m128i vmax = _mm_set1_epi16((short)0x8000);
+    __m128i vsum = zero;
+    __m128i vsq = zero;
+    __m128i vcount = zero;
+
+    for (size_t b = 0; b < blocks; b++) {
+        __m128i raw = _mm_loadu_si128((const __m128i*)(cell_mv + b * 8));
+        __m128i biased = _mm_xor_si128(raw, bias);
+        __m128i valid = _mm_cmpgt_epi16(biased_above_limit, biased);
+        // Out-of-range lanes: largest value for the minimum, 0 everywhere else
+        vmin = _mm_min_epi16(vmin, _mm_or_si128(_mm_and_si128(valid, biased), _mm_andnot_si128(valid, signed_max)));
+        __m128i v = _mm_and_si128(raw, valid);
+        vmax = _mm_max_epi16(vmax, _mm_xor_si128(v, bias));
+        vcount = _mm_sub_epi16(vcount, valid);   // Valid lanes are all ones (-1)
+
+        __m128i lo = _mm_unpacklo_epi16(v, zero);
+        __m128i hi = _mm_unpackhi_epi16(v, zero);
+        vsum = _mm_add_epi32(vsum, _mm_add_epi32(lo, hi));
+        // Signed pairwise products; exact for readings within MAX_CELL_MV
+        vsq = _mm_add_epi32(vsq, _mm_madd_epi16(v, v));
+    }
+
+    alignas(16) uint16_t lanes_min[8], lanes_max[8], lanes_count[8];
+    alignas(16) uint32_t lanes_sum[4], lanes_sq[4];
+    _mm_store_si128((__m128i*)lanes_min, _mm_xor_si128(vmin, bias));
+    _mm_store_si128((__m128i*)lanes_max, _mm_xor_si128(vmax, bias));
+    _mm_store_si128((__m128i*)lanes_count, vcount);
+    _mm_store_si128((__m128i*)lanes_sum, vsum);
+    _mm_store_si128((__m128i*)lanes_sq, vsq);
+
+    for (int i = 0; i < 8; i++) {
+        r.min_mv = std::min(r.min_mv, lanes_min[i]);
+        r.max_mv = std::max(r.max_mv, lanes_max[i]);
+        r.valid += lanes_count[i];
+    }
+    for (int i = 0; i < 4; i++) {
+        r.sum += lanes_sum[i];
+        r.sum_squares += lanes_sq[i];
+    }
+    return blocks * 8;
+}
+
+#else
+
+size_t reduceVector(const uint16_t*, size_t, Reduction&) {
+    return 0;
+}
+
+#endif
+
+} // namespace
+
+namespace CellStats {
+
+const char* kernelName() {
+#if defined(CELL_STATS_NEON)
+    return "NEON";
+#elif defined(CELL_STATS_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+void computeVoltages(const uint16_t* cell_mv, size_t count, CellStatistics& out) {
+    count = std::min(count, (size_t)MAX_CELLS);
+    out.cell_count = (int)count;
+
+    Reduction r;
+    size_t done = reduceVector(cell_mv, count, r);
+    reduceScalar(cell_mv, done, count, r);
+
+    out.valid_count = (int)r.valid;
+    out.invalid_count = (int)(count - r.valid);
+    if (r.valid == 0) {
+        out.min_mv = out.max_mv = out.spread_mv = 0;
+        out.mean_mv = out.imbalance_mv = 0.0f;
+        out.min_index = out.max_index = -1;
+        return;
+    }
+
+    out.min_mv = r.min_mv;
+    out.max_mv = r.max_mv;
+    out.spread_mv = r.max_mv - r.min_mv;
+
+    double mean = (double)r.sum / r.valid;
+    double variance = (double)r.sum_squares / r.valid - mean * mean;
+    out.mean_mv = (float)mean;
+    out.imbalance_mv = (float)std::sqrt(std::max(0.0, variance));
+
+    // First occurrence of the extremes; the values are already known so
+    // this is a plain compare scan (an out-of-range reading never matches)
+    out.min_index = out.max_index = -1;
+    for (size_t i = 0; i < count && (out.min_index < 0 || out.max_index < 0); i++) {
+        if (out.min_index < 0 && cell_mv[i] == r.min_mv) out.min_index = (int)i;
+        if (out.max_index < 0 && cell_mv[i] == r.max_mv) out.max_index = (int)i;
+    }
+}
+
+CellStatistics compute(const cell_data_t& cells) {
+    CellStatistics stats;
+    computeVoltages(cells.cell_mv, cells.cell_count, stats);
+
+    stats.temp_count = std::min<int>(cells.temp_count, MAX_CELLS);
+    if (stats.temp_count > 0) {
+        auto range = std::minmax_element(cells.temp_c, cells.temp_c + stats.temp_count);
+        stats.min_temp_c = *range.first;
+        stats.max_temp_c = *range.second;
+    }
+    return stats;
+}
+
+} // namespace CellStats
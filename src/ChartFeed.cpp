@@ -0,0 +1,122 @@
+#include "ChartFeed.h"
+#include <algorithm>
+
+// ---- ChartColumns ----
+
+void ChartColumns::clear(size_t columns) {
+    count = std::min(columns, MAX_COLUMNS);
+    std::fill(has, has + count, false);
+}
+
+void ChartColumns::merge(size_t column, float lo, float hi) {
+    if (has[column]) {
+        min[column] = std::min(min[column], lo);
+        max[column] = std::max(max[column], hi);
+    } else {
+        min[column] = lo;
+        max[column] = hi;
+        has[column] = true;
+    }
+}
+
+bool ChartColumns::range(float& lo, float& hi) const {
+    bool found = false;
+    for (size_t i = 0; i < count; i++) {
+        if (!has[i]) continue;
+        lo = found ? std::min(lo, min[i]) : min[i];
+        hi = found ? std::max(hi, max[i]) : max[i];
+        found = true;
+    }
+    return found;
+}
+
+// ---- MonotonicWindow ----
+
+void MonotonicWindow::push(uint64_t time_ms, float value) {
+    // Drop everything the new sample dominates; they can never be the extreme again
+    while (size > 0) {
+        const Entry& back = entries[(head + size - 1) % CAPACITY];
+        if (keep_max ? back.value > value : back.value < value) break;
+        size--;
+    }
+    if (size == CAPACITY) {
+        head = (head + 1) % CAPACITY;
+        size--;
+    }
+    entries[(head + size) % CAPACITY] = {time_ms, value};
+    size++;
+}
+
+void MonotonicWindow::expire(uint64_t now_ms, uint64_t window_ms) {
+    while (size > 0 && entries[head].time_ms + window_ms <= now_ms) {
+        head = (head + 1) % CAPACITY;
+        size--;
+    }
+}
+
+// ---- ChartFeed ----
+
+ChartFeed::ChartFeed(uint64_t window_ms) : window_ms(window_ms) {
+}
+
+void ChartFeed::add(float value, uint64_t time_ms) {
+    if (used) {
+        newest = (newest + 1) % CAPACITY;
+    }
+    used = std::min(used + 1, CAPACITY);
+    samples[newest] = {time_ms, value};
+
+    window_min.push(time_ms, value);
+    window_max.push(time_ms, value);
+    dirty = true;
+}
+
+bool ChartFeed::takeDirty() {
+    bool was_dirty = dirty;
+    dirty = false;
+    return was_dirty;
+}
+
+bool ChartFeed::extrema(uint64_t now_ms, float& lo, float& hi) {
+    window_min.expire(now_ms, window_ms);
+    window_max.expire(now_ms, window_ms);
+    if (window_min.empty()) return false;
+    lo = window_min.front();
+    hi = window_max.front();
+    return true;
+}
+
+void ChartFeed::decimate(uint64_t now_ms, size_t columns, ChartColumns& out) {
+    out.clear(columns);
+    if (out.count == 0) return;
+
+    // Newest first, back to the start of the window
+    for (size_t i = 0; i < used; i++) {
+        const Sample& sample = samples[(newest + CAPACITY - i) % CAPACITY];
+        if (sample.time_ms + window_ms <= now_ms) break;
+        if (sample.time_ms > now_ms) continue;
+
+        uint64_t age = now_ms - sample.time_ms;
+        size_t column = out.count - 1 - (size_t)(age * out.count / window_ms);
+        out.merge(column, sample.value, sample.value);
+    }
+}
+
+void ChartFeed::decimateBuckets(const HistoryBucket* buckets, size_t count, size_t columns, ChartColumns& out) {
+    out.clear(columns);
+    if (out.count == 0 || count == 0) return;
+
+    if (count >= out.count) {
+        // Several buckets per column: merge their extremes
+        for (size_t i = 0; i < count; i++) {
+            if (!buckets[i].count) continue;
+            out.merge(i * out.count / count, buckets[i].min, buckets[i].max);
+        }
+    } else {
+        // Fewer buckets than columns: each bucket spans several columns
+        for (size_t column = 0; column < out.count; column++) {
+            const HistoryBucket& bucket = buckets[column * count / out.count];
+            if (bucket.count) out.merge(column, bucket.min, bucket.max);
+        }
+    }
+}
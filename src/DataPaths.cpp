@@ -0,0 +1,35 @@
+#include "DataPaths.h"
+#include <cerrno>
+#include <cstdlib>
+#include <sys/stat.h>
+
+std::string dataDirectory() {
+    if (const char* dir = std::getenv("TAZZARI_DATA_DIR")) {
+        return dir;
+    }
+    if (const char* home = std::getenv("HOME")) {
+        return std::string(home) + "/.local/share/tazzari";
+    }
+    return ".";
+}
+
+bool makeDirectories(const std::string& dir) {
+    if (dir.empty()) return true;
+
+    size_t pos = 0;
+    while (pos != std::string::npos) {
+        pos = dir.find('/', pos + 1);
+        std::string partial = dir.substr(0, pos);
+        if (mkdir(partial.c_str(), 0755) != 0 && errno != EEXIST) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string directoryOf(const std::string& path) {
+    size_t slash = path.rfind('/');
+    if (slash == std::string::npos) return ".";
+    if (slash == 0) return "/";
+    return path.substr(0, slash);
+}
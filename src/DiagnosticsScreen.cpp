@@ -0,0 +1,108 @@
+#include "DiagnosticsScreen.h"
+#include <cstdio>
+#include <ctime>
+#include <string>
+
+DiagnosticsScreen::DiagnosticsScreen(const BatteryAlarms& alarms, const LatencyHistogram& loop_latency,
+                                     const LatencyHistogram& frame_time)
+    : alarms(alarms), loop_latency(loop_latency), frame_time(frame_time) {
+}
+
+void DiagnosticsScreen::setSerial(const SerialStats* stats, bool automotive, bool bms) {
+    serial_stats = stats;
+    automotive_live = automotive;
+    bms_live = bms;
+}
+
+lv_obj_t* DiagnosticsScreen::build() {
+    lv_obj_t* screen = createScreen("Diagnostics");
+    lbl_system = createLabel(screen, &lv_font_montserrat_16, 20, 60);
+    lbl_alarms = createLabel(screen, &lv_font_montserrat_16, 20, 330);
+    last_tick_ms = 0;
+    fps = 0.0f;
+    return screen;
+}
+
+void DiagnosticsScreen::release() {
+    lbl_system = nullptr;
+    lbl_alarms = nullptr;
+}
+
+void DiagnosticsScreen::tick(uint64_t now_ms) {
+    uint64_t frames = frame_time.getCount();
+    if (last_tick_ms && now_ms >= last_tick_ms + 1000) {
+        fps = (frames - last_frames) * 1000.0f / (now_ms - last_tick_ms);
+    }
+    if (!last_tick_ms || now_ms >= last_tick_ms + 1000) {
+        last_frames = frames;
+        last_tick_ms = now_ms;
+    }
+
+    char text[768];
+    int length = 0;
+    if (serial_stats) {
+        length += snprintf(text + length, sizeof(text) - length,
+                           "Serial     %s / %s   %llu bytes   frames: %llu auto  %llu bms  %llu cell   errors: %llu checksum  %llu framing\n",
+                           automotive_live ? "vehicle live" : "vehicle lost", bms_live ? "BMS live" : "BMS lost",
+                           (unsigned long long)serial_stats->bytes_received.load(),
+                           (unsigned long long)serial_stats->auto_packets.load(),
+                           (unsigned long long)serial_stats->bms_packets.load(),
+                           (unsigned long long)serial_stats->cell_packets.load(),
+                           (unsigned long long)serial_stats->checksum_errors.load(),
+                           (unsigned long long)serial_stats->framing_errors.load());
+    } else {
+        length += snprintf(text + length, sizeof(text) - length, "Serial     not connected\n");
+    }
+
+    length += snprintf(text + length, sizeof(text) - length,
+                       "Render     %.0f fps   %llu frames   slowest frame %.1f ms   slowest loop %.1f ms\n",
+                       fps, (unsigned long long)frames, frame_time.getMaxMs(), loop_latency.getMaxMs());
+
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    length += snprintf(text + length, sizeof(text) - length,
+                       "LVGL heap  %u / %u KB used   peak %u KB   %u%% fragmented\n",
+                       (unsigned)((mon.total_size - mon.free_size) / 1024), (unsigned)(mon.total_size / 1024),
+                       (unsigned)(mon.max_used / 1024), (unsigned)mon.frag_pct);
+    if (manager) {
+        snprintf(text + length, sizeof(text) - length, "Screens    %zu of %zu built   %zu / %zu KB",
+                 manager->getResidentCount(), manager->getScreenCount() - 1,
+                 manager->getResidentBytes() / 1024, manager->getBudget() / 1024);
+    }
+    setLabelText(lbl_system, text);
+
+    showAlarms();
+}
+
+void DiagnosticsScreen::showAlarms() {
+    size_t events = alarms.getHistoryCount();
+
+    const std::vector<AlarmRule>& rules = alarms.getRules();
+    std::string text = "Alarms (" + alarms.getChemistry() + ")   active:";
+    bool any_active = false;
+    for (size_t i = 0; i < rules.size(); i++) {
+        if (!alarms.isActive(i)) continue;
+        text += std::string(" ") + BatteryAlarms::signalName(rules[i].signal) + " " + BatteryAlarms::severityName(rules[i].severity);
+        any_active = true;
+    }
+    if (!any_active) text += " none";
+    text += "\n";
+
+    // Newest first
+    for (size_t n = 0; n < ALARM_LINES && n < events; n++) {
+        const AlarmEvent& event = alarms.getHistory(events - 1 - n);
+        if (event.rule >= rules.size()) continue;   // From before a rule reload
+        const AlarmRule& rule = rules[event.rule];
+
+        struct tm local;
+        localtime_r(&event.time, &local);
+        char when[16];
+        strftime(when, sizeof(when), "%H:%M:%S", &local);
+
+        char line[128];
+        snprintf(line, sizeof(line), "%s   %-8s %-14s %s at %.2f\n", when, BatteryAlarms::severityName(rule.severity),
+                 BatteryAlarms::signalName(rule.signal), event.raised ? "raised" : "cleared", event.value);
+        text += line;
+    }
+    setLabelText(lbl_alarms, text.c_str());
+}
@@ -0,0 +1,120 @@
+#include "EnergyAccumulator.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+// ---- RollingConsumption ----
+
+RollingConsumption::RollingConsumption(double window_km, size_t bins)
+    : window_km(window_km), bins(std::min(std::max(bins, (size_t)1), MAX_BINS)) {
+    bin_km = window_km / this->bins;
+}
+
+void RollingConsumption::reset() {
+    head = 0;
+    used = 0;
+    sum_wh = sum_km = 0.0;
+    open_wh = open_km = 0.0;
+}
+
+void RollingConsumption::add(double net_wh, double km) {
+    open_wh += net_wh;
+    open_km += km;
+    if (open_km < bin_km) return;
+
+    // Close the bin; a single tick never covers more than one bin in practice
+    Bin& slot = ring[(head + used) % bins];
+    if (used == bins) {
+        Bin& oldest = ring[head];
+        sum_wh -= oldest.wh;
+        sum_km -= oldest.km;
+        head = (head + 1) % bins;
+        used--;
+    }
+    slot.wh = open_wh;
+    slot.km = open_km;
+    sum_wh += slot.wh;
+    sum_km += slot.km;
+    used++;
+    open_wh = open_km = 0.0;
+}
+
+double RollingConsumption::whPerKm(double min_km) const {
+    double km = sum_km + open_km;
+    if (km < min_km) return 0.0;
+    return (sum_wh + open_wh) / km;
+}
+
+// ---- EnergyAccumulator ----
+
+EnergyAccumulator::EnergyAccumulator(EnergyConfig config) {
+    std::sort(config.window_km, config.window_km + WINDOW_COUNT);
+    for (size_t i = 0; i < WINDOW_COUNT; i++) {
+        windows[i] = RollingConsumption(config.window_km[i]);
+    }
+}
+
+EnergyConfig EnergyAccumulator::configFromEnvironment() {
+    EnergyConfig config;
+    const char* env = std::getenv("TAZZARI_CONSUMPTION_WINDOWS_KM");
+    if (!env) return config;
+
+    // All windows or none - a partial list would mix with the defaults
+    EnergyConfig parsed;
+    const char* p = env;
+    for (size_t i = 0; i < WINDOW_COUNT; i++) {
+        char* end;
+        double km = strtod(p, &end);
+        if (end == p || km < 0.1 || (i + 1 < WINDOW_COUNT && *end != ',')) {
+            std::cout << "Energy: Ignoring TAZZARI_CONSUMPTION_WINDOWS_KM=" << env
+                      << " (expected " << WINDOW_COUNT << " comma-separated km values)" << std::endl;
+            return config;
+        }
+        parsed.window_km[i] = km;
+        p = end + 1;
+    }
+    return parsed;
+}
+
+EnergyTotals EnergyAccumulator::addFrame(float voltage, float current, uint32_t timestamp_ms) {
+    EnergyTotals step;
+
+    // BMS convention: negative current is discharge. Flip so power is positive while driving.
+    double power_w = -(double)voltage * current;
+    power_kw = power_w / 1000.0;
+
+    // Unsigned difference handles the ESP32 millis() wrap
+    uint32_t dt_ms = timestamp_ms - last_timestamp;
+    if (has_frame && dt_ms > 0 && dt_ms <= MAX_FRAME_GAP_MS) {
+        double wh = (last_power_w + power_w) * 0.5 * dt_ms / 3600000.0;
+        if (wh >= 0.0) {
+            step.used_wh = wh;
+        } else if (moving) {
+            step.regen_wh = -wh;
+        }
+
+        trip.add(step);
+        lifetime.add(step);
+        for (RollingConsumption& window : windows) {
+            window.add(step.netWh(), 0.0);
+        }
+    }
+
+    has_frame = true;
+    last_timestamp = timestamp_ms;
+    last_power_w = power_w;
+    return step;
+}
+
+void EnergyAccumulator::addDistance(double km) {
+    moving = km > 0.0;
+    if (!moving) return;
+    for (RollingConsumption& window : windows) {
+        window.add(0.0, km);
+    }
+}
+
+void EnergyAccumulator::restore(const EnergyTotals& trip_totals, const EnergyTotals& lifetime_totals) {
+    trip = trip_totals;
+    lifetime = lifetime_totals;
+}
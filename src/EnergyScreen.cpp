@@ -0,0 +1,89 @@
+#include "EnergyScreen.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+EnergyScreen::EnergyScreen(const EnergyAccumulator& energy, const RangeEstimator& range, const TimeSeriesPyramid& history)
+    : energy(energy), range(range), history(history) {
+}
+
+lv_obj_t* EnergyScreen::build() {
+    lv_obj_t* screen = createScreen("Energy");
+    lbl_totals = createLabel(screen, &lv_font_montserrat_18, 20, 60);
+
+    // kW on the left axis, SOC % on the right
+    chart = lv_chart_create(screen);
+    lv_obj_set_pos(chart, 20, 330);
+    lv_obj_set_size(chart, 984, 250);
+    lv_chart_set_type(chart, LV_CHART_TYPE_LINE);
+    lv_chart_set_range(chart, LV_CHART_AXIS_PRIMARY_Y, -10, 20);
+    lv_chart_set_range(chart, LV_CHART_AXIS_SECONDARY_Y, 0, 100);
+    lv_obj_set_style_size(chart, 0, 0, LV_PART_INDICATOR);
+    power_series = lv_chart_add_series(chart, lv_color_hex(0x2196f3), LV_CHART_AXIS_PRIMARY_Y);
+    soc_series = lv_chart_add_series(chart, lv_color_hex(0x4caf50), LV_CHART_AXIS_SECONDARY_Y);
+
+    size_t level = history.levelFor(CHART_WINDOW_MS, CHART_POINTS);
+    size_t points = CHART_WINDOW_MS / TimeSeriesPyramid::LEVEL_MS[level];
+    lv_chart_set_point_count(chart, points);
+    buckets.resize(points);
+    chart_bucket = -1;
+    return screen;
+}
+
+void EnergyScreen::release() {
+    lbl_totals = nullptr;
+    chart = nullptr;
+    power_series = nullptr;
+    soc_series = nullptr;
+    buckets.clear();
+    buckets.shrink_to_fit();
+}
+
+void EnergyScreen::tick(uint64_t now_ms) {
+    const EnergyTotals& trip = energy.getTrip();
+    const EnergyTotals& lifetime = energy.getLifetime();
+    const RangeEstimate& estimate = range.getEstimate();
+
+    char text[512];
+    int length = snprintf(text, sizeof(text),
+                          "Power          %6.1f kW\n"
+                          "Trip           %6.2f kWh used   %6.2f kWh regen   %6.2f kWh net\n"
+                          "Lifetime       %6.0f kWh used   %6.0f kWh regen\n"
+                          "Consumption    %4.0f Wh/km (%g km)   %4.0f (%g km)   %4.0f (%g km)   learned %.0f\n",
+                          energy.getPowerKw(),
+                          trip.used_wh / 1000.0, trip.regen_wh / 1000.0, trip.netWh() / 1000.0,
+                          lifetime.used_wh / 1000.0, lifetime.regen_wh / 1000.0,
+                          energy.getWindow(0).whPerKm(), energy.getWindow(0).getWindowKm(),
+                          energy.getWindow(1).whPerKm(), energy.getWindow(1).getWindowKm(),
+                          energy.getWindow(2).whPerKm(), energy.getWindow(2).getWindowKm(),
+                          range.getLearnedWhPerKm());
+    if (estimate.valid) {
+        snprintf(text + length, sizeof(text) - length, "Range          %4.0f km   (%.0f-%.0f km at %.0f Wh/km)",
+                 estimate.km, estimate.low_km, estimate.high_km, estimate.wh_per_km);
+    } else {
+        snprintf(text + length, sizeof(text) - length, "Range          ---");
+    }
+    setLabelText(lbl_totals, text);
+
+    drawChart(now_ms);
+}
+
+void EnergyScreen::drawChart(uint64_t now_ms) {
+    size_t level = history.levelFor(CHART_WINDOW_MS, CHART_POINTS);
+    int64_t bucket = TimeSeriesPyramid::bucketIndex(level, now_ms);
+    if (bucket == chart_bucket) return;
+    chart_bucket = bucket;
+
+    int32_t* power = lv_chart_get_y_array(chart, power_series);
+    history.read(HISTORY_POWER, level, now_ms, buckets.size(), buckets.data());
+    for (size_t i = 0; i < buckets.size(); i++) {
+        power[i] = buckets[i].count ? (int32_t)lrintf(buckets[i].mean()) : LV_CHART_POINT_NONE;
+    }
+
+    int32_t* soc = lv_chart_get_y_array(chart, soc_series);
+    history.read(HISTORY_SOC, level, now_ms, buckets.size(), buckets.data());
+    for (size_t i = 0; i < buckets.size(); i++) {
+        soc[i] = buckets[i].count ? (int32_t)lrintf(buckets[i].mean()) : LV_CHART_POINT_NONE;
+    }
+    lv_chart_refresh(chart);
+}
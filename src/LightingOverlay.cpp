@@ -0,0 +1,151 @@
+#include "LightingOverlay.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+void LightingOverlay::attach(lv_obj_t* const images[LAMPS]) {
+    lv_obj_t* parent = lv_obj_get_parent(images[0]);
+    lv_obj_update_layout(parent);
+
+    lv_area_t coords[LAMPS];
+    for (int i = 0; i < LAMPS; i++) {
+        lv_obj_get_coords(images[i], &coords[i]);
+        if (i == 0) {
+            bounds = coords[i];
+        } else {
+            bounds.x1 = std::min(bounds.x1, coords[i].x1);
+            bounds.y1 = std::min(bounds.y1, coords[i].y1);
+            bounds.x2 = std::max(bounds.x2, coords[i].x2);
+            bounds.y2 = std::max(bounds.y2, coords[i].y2);
+        }
+    }
+
+    atlas.clear();
+    for (int i = 0; i < LAMPS; i++) {
+        rasterize(i, images[i], coords[i]);
+    }
+    // Descriptors point into the atlas only once it has stopped growing
+    for (Sprite& sprite : sprites) {
+        sprite.image.data = atlas.data() + sprite.offset;
+    }
+
+    lv_area_t parent_coords;
+    lv_obj_get_coords(parent, &parent_coords);
+
+    obj = lv_obj_create(parent);
+    lv_obj_remove_style_all(obj);
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_pos(obj, bounds.x1 - parent_coords.x1, bounds.y1 - parent_coords.y1);
+    lv_obj_set_size(obj, lv_area_get_width(&bounds), lv_area_get_height(&bounds));
+    lv_obj_move_to_index(obj, lv_obj_get_index(images[0]));
+    lv_obj_add_event_cb(obj, drawEvent, LV_EVENT_DRAW_MAIN, this);
+
+    for (int i = 0; i < LAMPS; i++) {
+        lv_obj_add_flag(images[i], LV_OBJ_FLAG_HIDDEN);
+    }
+    lights = 0;
+
+    std::cout << "LightingOverlay: " << LAMPS << " lamps, " << atlas.size() / 1024 << " KB atlas" << std::endl;
+}
+
+// Draw the image on a throwaway ARGB8888 canvas and keep the rectangle its
+// visible pixels cover
+void LightingOverlay::rasterize(int lamp, lv_obj_t* image, const lv_area_t& coords) {
+    Sprite& sprite = sprites[lamp];
+    memset(&sprite, 0, sizeof(sprite));
+
+    int32_t w = lv_area_get_width(&coords);
+    int32_t h = lv_area_get_height(&coords);
+    uint32_t canvas_stride = lv_draw_buf_width_to_stride(w, LV_COLOR_FORMAT_ARGB8888);
+    std::vector<uint8_t> canvas_buf((size_t)canvas_stride * h);
+
+    lv_obj_t* canvas = lv_canvas_create(lv_layer_top());
+    lv_canvas_set_buffer(canvas, canvas_buf.data(), w, h, LV_COLOR_FORMAT_ARGB8888);
+    lv_canvas_fill_bg(canvas, lv_color_black(), LV_OPA_TRANSP);
+
+    lv_layer_t layer;
+    lv_canvas_init_layer(canvas, &layer);
+    lv_draw_image_dsc_t image_dsc;
+    lv_draw_image_dsc_init(&image_dsc);
+    image_dsc.src = lv_image_get_src(image);
+    lv_area_t area = {0, 0, w - 1, h - 1};
+    lv_draw_image(&layer, &image_dsc, &area);
+    lv_canvas_finish_layer(canvas, &layer);
+    lv_obj_delete(canvas);
+
+    int32_t x1 = w, y1 = h, x2 = -1, y2 = -1;
+    for (int32_t y = 0; y < h; y++) {
+        const uint8_t* row = canvas_buf.data() + (size_t)y * canvas_stride;
+        for (int32_t x = 0; x < w; x++) {
+            if (!row[x * 4 + 3]) continue;
+            x1 = std::min(x1, x);
+            x2 = std::max(x2, x);
+            y1 = std::min(y1, y);
+            y2 = std::max(y2, y);
+        }
+    }
+    if (x2 < 0) {
+        sprite.area = {0, 0, -1, -1};
+        return;
+    }
+
+    int32_t crop_w = x2 - x1 + 1;
+    int32_t crop_h = y2 - y1 + 1;
+    sprite.offset = atlas.size();
+    atlas.resize(atlas.size() + (size_t)crop_w * crop_h * 4);
+    for (int32_t y = 0; y < crop_h; y++) {
+        memcpy(atlas.data() + sprite.offset + (size_t)y * crop_w * 4,
+               canvas_buf.data() + (size_t)(y1 + y) * canvas_stride + x1 * 4, (size_t)crop_w * 4);
+    }
+
+    int32_t dx = coords.x1 - bounds.x1;
+    int32_t dy = coords.y1 - bounds.y1;
+    sprite.area = {dx + x1, dy + y1, dx + x2, dy + y2};
+
+    sprite.image.header.magic = LV_IMAGE_HEADER_MAGIC;
+    sprite.image.header.cf = LV_COLOR_FORMAT_ARGB8888;
+    sprite.image.header.w = crop_w;
+    sprite.image.header.h = crop_h;
+    sprite.image.header.stride = crop_w * 4;
+    sprite.image.data_size = crop_w * crop_h * 4;
+}
+
+void LightingOverlay::spriteArea(int lamp, lv_area_t& area) const {
+    lv_area_t coords;
+    lv_obj_get_coords(obj, &coords);
+    area = sprites[lamp].area;
+    lv_area_move(&area, coords.x1, coords.y1);
+}
+
+void LightingOverlay::setLights(uint8_t mask) {
+    mask &= LAMP_ALL;
+    if (!obj || mask == lights) return;
+
+    uint8_t changed = mask ^ lights;
+    lights = mask;
+    for (int i = 0; i < LAMPS; i++) {
+        if (!(changed & (1 << i)) || sprites[i].area.x2 < 0) continue;
+        lv_area_t area;
+        spriteArea(i, area);
+        lv_obj_invalidate_area(obj, &area);
+    }
+}
+
+void LightingOverlay::drawEvent(lv_event_t* e) {
+    LightingOverlay* self = (LightingOverlay*)lv_event_get_user_data(e);
+    lv_layer_t* layer = lv_event_get_layer(e);
+
+    lv_draw_image_dsc_t image_dsc;
+    lv_draw_image_dsc_init(&image_dsc);
+    image_dsc.opa = lv_obj_get_style_opa_recursive(self->obj, LV_PART_MAIN);
+
+    // Same order as the EEZ images; sprites outside the clip are dropped
+    for (int i = 0; i < LAMPS; i++) {
+        if (!(self->lights & (1 << i)) || self->sprites[i].area.x2 < 0) continue;
+        lv_area_t area;
+        self->spriteArea(i, area);
+        image_dsc.src = &self->sprites[i].image;
+        lv_draw_image(layer, &image_dsc, &area);
+    }
+}
@@ -0,0 +1,215 @@
+#include "MetricsExporter.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <poll.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+// Frame-time oriented: 16/33 ms are the 60/30 fps budgets
+const double LatencyHistogram::BUCKET_BOUNDS_MS[BUCKET_COUNT] = {
+    1, 2, 5, 10, 16, 25, 33, 50, 100, 250, 500, 1000
+};
+
+void LatencyHistogram::observe(double ms) {
+    uint64_t us = ms > 0 ? (uint64_t)(ms * 1000.0) : 0;
+
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        if (ms <= BUCKET_BOUNDS_MS[i]) {
+            buckets[i].fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+    }
+    count.fetch_add(1, std::memory_order_relaxed);
+    sum_us.fetch_add(us, std::memory_order_relaxed);
+
+    uint64_t previous_max = max_us.load(std::memory_order_relaxed);
+    while (us > previous_max &&
+           !max_us.compare_exchange_weak(previous_max, us, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::observeSince(std::chrono::steady_clock::time_point start) {
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    observe(std::chrono::duration<double, std::milli>(elapsed).count());
+}
+
+void LatencyHistogram::write(std::ostream& out, const char* name, const char* help) const {
+    out << "# HELP " << name << " " << help << "\n";
+    out << "# TYPE " << name << " histogram\n";
+
+    // Buckets are stored non-cumulative, Prometheus wants them cumulative
+    uint64_t cumulative = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        cumulative += buckets[i].load(std::memory_order_relaxed);
+        out << name << "_bucket{le=\"" << BUCKET_BOUNDS_MS[i] / 1000.0 << "\"} " << cumulative << "\n";
+    }
+    uint64_t total = count.load(std::memory_order_relaxed);
+    out << name << "_bucket{le=\"+Inf\"} " << total << "\n";
+    out << name << "_sum " << sum_us.load(std::memory_order_relaxed) / 1e6 << "\n";
+    out << name << "_count " << total << "\n";
+}
+
+MetricsExporter::MetricsExporter(int port) : port(port) {
+}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+bool MetricsExporter::start() {
+    listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        std::cerr << "Metrics: Cannot create socket: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    int reuse = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    // Localhost only - scrape through node_exporter textfile or an SSH tunnel
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(listen_fd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(listen_fd, 4) < 0) {
+        std::cerr << "Metrics: Cannot listen on 127.0.0.1:" << port << ": " << strerror(errno) << std::endl;
+        close(listen_fd);
+        listen_fd = -1;
+        return false;
+    }
+
+    running = true;
+    server_thread = std::thread(&MetricsExporter::serverLoop, this);
+    std::cout << "Metrics: Serving http://127.0.0.1:" << port << "/metrics" << std::endl;
+    return true;
+}
+
+void MetricsExporter::stop() {
+    if (!running.exchange(false)) return;
+
+    if (server_thread.joinable()) {
+        server_thread.join();
+    }
+    if (listen_fd >= 0) {
+        close(listen_fd);
+        listen_fd = -1;
+    }
+}
+
+void MetricsExporter::addCollector(std::function<void(std::ostream&)> collector) {
+    std::lock_guard<std::mutex> lock(collectors_mutex);
+    collectors.push_back(std::move(collector));
+}
+
+void MetricsExporter::writeGauge(std::ostream& out, const char* name, const char* help, double value) {
+    out << "# HELP " << name << " " << help << "\n";
+    out << "# TYPE " << name << " gauge\n";
+    out << name << " " << value << "\n";
+}
+
+void MetricsExporter::writeCounter(std::ostream& out, const char* name, const char* help, double value) {
+    out << "# HELP " << name << " " << help << "\n";
+    out << "# TYPE " << name << " counter\n";
+    out << name << " " << value << "\n";
+}
+
+void MetricsExporter::serverLoop() {
+    while (running) {
+        // Wake up regularly to notice stop()
+        pollfd pfd = {listen_fd, POLLIN, 0};
+        if (poll(&pfd, 1, 500) <= 0) continue;
+
+        int client_fd = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client_fd < 0) continue;
+
+        handleClient(client_fd);
+        close(client_fd);
+    }
+}
+
+void MetricsExporter::handleClient(int client_fd) {
+    // Only the request line matters; wait briefly for it
+    char request[1024];
+    pollfd pfd = {client_fd, POLLIN, 0};
+    if (poll(&pfd, 1, 1000) <= 0) return;
+
+    ssize_t length = recv(client_fd, request, sizeof(request) - 1, 0);
+    if (length <= 0) return;
+    request[length] = '\0';
+
+    std::string status = "200 OK";
+    std::string body;
+    if (strncmp(request, "GET /metrics", 12) == 0 || strncmp(request, "GET / ", 6) == 0) {
+        body = renderPage();
+    } else {
+        status = "404 Not Found";
+        body = "Not found - try /metrics\n";
+    }
+
+    std::ostringstream response;
+    response << "HTTP/1.0 " << status << "\r\n"
+             << "Content-Type: text/plain; version=0.0.4\r\n"
+             << "Content-Length: " << body.size() << "\r\n"
+             << "Connection: close\r\n\r\n"
+             << body;
+
+    std::string data = response.str();
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(client_fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) break;
+        sent += n;
+    }
+}
+
+std::string MetricsExporter::renderPage() {
+    std::ostringstream out;
+    out.precision(15);  // Byte counts must not end up in e-notation
+
+    writeProcessMetrics(out);
+    {
+        std::lock_guard<std::mutex> lock(collectors_mutex);
+        for (auto& collector : collectors) {
+            collector(out);
+        }
+    }
+    writeCounter(out, "tazzari_metrics_scrapes_total", "Scrapes served by this exporter", ++scrapes);
+
+    return out.str();
+}
+
+void MetricsExporter::writeProcessMetrics(std::ostream& out) {
+    std::ifstream stat_file("/proc/self/stat");
+    std::string stat;
+    if (!std::getline(stat_file, stat)) return;
+
+    // Field 2 (comm) may contain spaces - parse from after the closing paren.
+    // Remaining fields start at 3 (state); utime=14, stime=15, rss=24.
+    size_t paren = stat.rfind(')');
+    if (paren == std::string::npos) return;
+
+    std::istringstream fields(stat.substr(paren + 2));
+    std::string field;
+    unsigned long long utime = 0, stime = 0;
+    long long rss_pages = 0;
+    for (int index = 3; fields >> field; index++) {
+        if (index == 14) utime = std::stoull(field);
+        else if (index == 15) stime = std::stoull(field);
+        else if (index == 24) { rss_pages = std::stoll(field); break; }
+    }
+
+    double ticks = sysconf(_SC_CLK_TCK);
+    double page_size = sysconf(_SC_PAGESIZE);
+
+    writeCounter(out, "process_cpu_user_seconds_total", "User CPU time from /proc/self/stat", utime / ticks);
+    writeCounter(out, "process_cpu_system_seconds_total", "System CPU time from /proc/self/stat", stime / ticks);
+    writeCounter(out, "process_cpu_seconds_total", "Total CPU time from /proc/self/stat", (utime + stime) / ticks);
+    writeGauge(out, "process_resident_memory_bytes", "Resident set size", rss_pages * page_size);
+}
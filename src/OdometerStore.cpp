@@ -0,0 +1,179 @@
+#include "OdometerStore.h"
+#include "Crc32.h"
+#include "DataPaths.h"
+#include "Trace.h"
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <cstddef>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+OdometerStore::OdometerStore(const std::string& path) : path(path) {
+}
+
+OdometerStore::~OdometerStore() {
+    close();
+}
+
+std::string OdometerStore::defaultPath() {
+    return dataDirectory() + "/odometer.jrnl";
+}
+
+bool OdometerStore::open() {
+    std::string dir = directoryOf(path);
+    if (!makeDirectories(dir)) {
+        std::cerr << "Storage: Cannot create " << dir << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "Storage: Cannot open " << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    if (!preallocate()) {
+        close();
+        return false;
+    }
+
+    recover();
+    return true;
+}
+
+void OdometerStore::close() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+bool OdometerStore::preallocate() {
+    struct stat st;
+    if (fstat(fd, &st) != 0) return false;
+    if ((size_t)st.st_size >= FILE_SIZE) return true;
+
+    // New (or short) journal: reserve every slot up front so later writes
+    // never change the file size - no metadata updates on the hot path
+    int err = posix_fallocate(fd, 0, FILE_SIZE);
+    if (err != 0) {
+        std::cerr << "Storage: Cannot preallocate " << path << ": " << strerror(err) << std::endl;
+        return false;
+    }
+    fsync(fd);
+
+    // Make the new directory entry durable too
+    int dir_fd = ::open(directoryOf(path).c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir_fd >= 0) {
+        fsync(dir_fd);
+        ::close(dir_fd);
+    }
+
+    std::cout << "Storage: Created journal " << path << " (" << SLOT_COUNT << " slots)" << std::endl;
+    return true;
+}
+
+void OdometerStore::encodeRecord(const OdometerState& state, uint64_t sequence, OdometerRecord& record) {
+    memset(&record, 0, sizeof(record));
+    record.magic = ODOMETER_MAGIC;
+    record.version = ODOMETER_VERSION;
+    record.size = sizeof(OdometerRecord);
+    record.sequence = sequence;
+    record.odo_km = state.odo_km;
+    record.trip_km = state.trip_km;
+    record.soc_percent = state.soc_percent;
+    record.flags = state.soc_valid ? ODOMETER_FLAG_SOC_VALID : 0;
+    record.trip_used_kwh = state.trip_used_kwh;
+    record.trip_regen_kwh = state.trip_regen_kwh;
+    record.lifetime_used_kwh = state.lifetime_used_kwh;
+    record.lifetime_regen_kwh = state.lifetime_regen_kwh;
+    record.learned_wh_per_km = state.learned_wh_per_km;
+    record.crc = crc32(&record, offsetof(OdometerRecord, crc));
+}
+
+bool OdometerStore::isValidRecord(const OdometerRecord& record) {
+    return record.magic == ODOMETER_MAGIC &&
+           record.version == ODOMETER_VERSION &&
+           record.size == sizeof(OdometerRecord) &&
+           record.sequence != 0 &&
+           record.crc == crc32(&record, offsetof(OdometerRecord, crc));
+}
+
+void OdometerStore::recover() {
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<uint8_t> file_data(FILE_SIZE);
+    ssize_t length = pread(fd, file_data.data(), FILE_SIZE, 0);
+    if (length < 0) length = 0;
+
+    uint64_t best_sequence = 0;
+    int valid_slots = 0;
+    for (int slot = 0; slot < SLOT_COUNT; slot++) {
+        size_t offset = (size_t)slot * SLOT_SIZE;
+        if (offset + sizeof(OdometerRecord) > (size_t)length) break;
+
+        OdometerRecord record;
+        memcpy(&record, file_data.data() + offset, sizeof(record));
+        if (!isValidRecord(record)) continue;
+
+        valid_slots++;
+        if (record.sequence > best_sequence) {
+            best_sequence = record.sequence;
+            state.odo_km = record.odo_km;
+            state.trip_km = record.trip_km;
+            state.soc_percent = record.soc_percent;
+            state.soc_valid = (record.flags & ODOMETER_FLAG_SOC_VALID) != 0;
+            state.trip_used_kwh = record.trip_used_kwh;
+            state.trip_regen_kwh = record.trip_regen_kwh;
+            state.lifetime_used_kwh = record.lifetime_used_kwh;
+            state.lifetime_regen_kwh = record.lifetime_regen_kwh;
+            state.learned_wh_per_km = record.learned_wh_per_km;
+        }
+    }
+
+    has_state = best_sequence != 0;
+    next_sequence = best_sequence + 1;
+    uint64_t elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    recovery_time_us.store(elapsed_us, std::memory_order_relaxed);
+
+    if (has_state) {
+        std::cout << "Storage: Recovered record #" << best_sequence << " (" << valid_slots << "/"
+                  << SLOT_COUNT << " slots valid) in " << elapsed_us << "us" << std::endl;
+    } else {
+        std::cout << "Storage: No valid record in " << path << std::endl;
+    }
+}
+
+bool OdometerStore::save(const OdometerState& new_state) {
+    if (fd < 0) return false;
+    TRACE_SCOPE("odometer_save");
+
+    // Whole sector per write - the record plus zero padding
+    uint8_t slot_data[SLOT_SIZE] = {0};
+    OdometerRecord record;
+    encodeRecord(new_state, next_sequence, record);
+    memcpy(slot_data, &record, sizeof(record));
+
+    off_t offset = (off_t)(next_sequence % SLOT_COUNT) * SLOT_SIZE;
+    ssize_t written = pwrite(fd, slot_data, SLOT_SIZE, offset);
+    if (written != (ssize_t)SLOT_SIZE) {
+        std::cerr << "Storage: Write failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+    if (fdatasync(fd) != 0) {
+        std::cerr << "Storage: fdatasync failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    state = new_state;
+    has_state = true;
+    next_sequence++;
+    write_count.fetch_add(1, std::memory_order_relaxed);
+    bytes_written.fetch_add(SLOT_SIZE, std::memory_order_relaxed);
+    return true;
+}
@@ -0,0 +1,106 @@
+#include "PacketDecoder.h"
+#include <cstring>
+
+bool PacketDecoder::isKnownType(uint8_t type) {
+    return type == BMS_PACKET_TYPE || type == AUTO_PACKET_TYPE || type == CELL_PACKET_TYPE;
+}
+
+bool PacketDecoder::decodeBMS(const uint8_t* payload, uint8_t length, bms_data_t& out) {
+    if (length != sizeof(bms_data_t)) return false;
+    memcpy(&out, payload, sizeof(bms_data_t));
+    return true;
+}
+
+bool PacketDecoder::decodeAutomotive(const uint8_t* payload, uint8_t length, automotive_data_t& out) {
+    if (length != sizeof(automotive_data_t)) return false;
+    memcpy(&out, payload, sizeof(automotive_data_t));
+    return true;
+}
+
+bool PacketDecoder::decodeCells(const uint8_t* payload, uint8_t length, cell_data_t& out) {
+    const size_t header = 6;
+    if (length < header) return false;
+
+    uint8_t cells = payload[4];
+    uint8_t temps = payload[5];
+    if (cells > MAX_CELLS || temps > MAX_CELLS) return false;
+    if (length != header + cells * sizeof(uint16_t) + temps) return false;
+
+    memcpy(&out.timestamp, payload, sizeof(uint32_t));
+    out.cell_count = cells;
+    out.temp_count = temps;
+    memcpy(out.cell_mv, payload + header, cells * sizeof(uint16_t));
+    memcpy(out.temp_c, payload + header + cells * sizeof(uint16_t), temps);
+    return true;
+}
+
+void PacketDecoder::error(PacketError error) {
+    if (error_callback) {
+        error_callback(error);
+    }
+}
+
+void PacketDecoder::feed(const uint8_t* data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        uint8_t byte = data[i];
+
+        switch (state) {
+            case STATE_START:
+                if (byte == PACKET_START_BYTE) {
+                    state = STATE_TYPE;
+                }
+                break;
+
+            case STATE_TYPE:
+                if (isKnownType(byte)) {
+                    packet_type = byte;
+                    checksum = byte;
+                    state = STATE_LENGTH;
+                } else {
+                    error(PACKET_ERROR_FRAMING);
+                    state = STATE_START;
+                }
+                break;
+
+            case STATE_LENGTH:
+                packet_length = byte;
+                checksum ^= byte;
+                if (packet_length > 0) {
+                    data_index = 0;
+                    state = STATE_PAYLOAD;
+                } else {
+                    error(PACKET_ERROR_FRAMING);
+                    state = STATE_START;
+                }
+                break;
+
+            case STATE_PAYLOAD:
+                payload[data_index++] = byte;
+                checksum ^= byte;
+                if (data_index >= packet_length) {
+                    state = STATE_CHECKSUM;
+                }
+                break;
+
+            case STATE_CHECKSUM:
+                if (byte == checksum) {
+                    state = STATE_END;
+                } else {
+                    error(PACKET_ERROR_CHECKSUM);
+                    state = STATE_START;
+                }
+                break;
+
+            case STATE_END:
+                if (byte == PACKET_END_BYTE) {
+                    if (packet_callback) {
+                        packet_callback(packet_type, payload, packet_length);
+                    }
+                } else {
+                    error(PACKET_ERROR_FRAMING);
+                }
+                state = STATE_START;
+                break;
+        }
+    }
+}
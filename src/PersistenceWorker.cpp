@@ -0,0 +1,144 @@
+#include "PersistenceWorker.h"
+#include "Trace.h"
+#include <iostream>
+#include <cmath>
+
+PersistenceWorker::PersistenceWorker(OdometerStore& store, PersistencePolicy policy)
+    : store(store), policy(policy) {
+}
+
+PersistenceWorker::~PersistenceWorker() {
+    stop();
+}
+
+void PersistenceWorker::start() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (running) return;
+
+    // Baseline is whatever the store recovered in open()
+    last_written = store.getState();
+    last_write_time = std::chrono::steady_clock::now();
+
+    running = true;
+    worker_thread = std::thread(&PersistenceWorker::workerLoop, this);
+}
+
+void PersistenceWorker::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) return;
+        running = false;
+    }
+    wake.notify_one();
+
+    // workerLoop() writes the pending snapshot before it returns
+    if (worker_thread.joinable()) {
+        worker_thread.join();
+    }
+    std::cout << "Storage: Persistence worker stopped (" << getWrites() << " writes for "
+              << getSubmitted() << " snapshots)" << std::endl;
+}
+
+void PersistenceWorker::submit(const OdometerState& state) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending = state;
+        has_pending = true;
+    }
+    submitted.fetch_add(1, std::memory_order_relaxed);
+    wake.notify_one();
+}
+
+void PersistenceWorker::post(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (running) {
+            jobs.push_back(std::move(job));
+            job = nullptr;
+        }
+    }
+    if (job) {
+        // No worker (not started or already stopped) - run it here
+        job();
+        return;
+    }
+    wake.notify_one();
+}
+
+void PersistenceWorker::flush() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        flush_requested = true;
+    }
+    wake.notify_one();
+}
+
+bool PersistenceWorker::shouldWrite(const OdometerState& state, std::chrono::steady_clock::time_point now) const {
+    bool moved = std::fabs(state.odo_km - last_written.odo_km) >= policy.min_distance_km ||
+                 std::fabs(state.trip_km - last_written.trip_km) >= policy.min_distance_km;
+    if (moved) return true;
+
+    bool changed = state.odo_km != last_written.odo_km ||
+                   state.trip_km != last_written.trip_km ||
+                   state.soc_valid != last_written.soc_valid ||
+                   std::fabs(state.soc_percent - last_written.soc_percent) >= 1.0f ||
+                   std::fabs(state.lifetime_used_kwh - last_written.lifetime_used_kwh) >= 0.01f ||
+                   std::fabs(state.lifetime_regen_kwh - last_written.lifetime_regen_kwh) >= 0.01f;
+    return changed && now - last_write_time >= policy.max_interval;
+}
+
+bool PersistenceWorker::write(const OdometerState& state, std::chrono::steady_clock::time_point now) {
+    TRACE_SCOPE("persistence_write");
+    if (!store.save(state)) return false;
+
+    last_written = state;
+    last_write_time = now;
+    writes.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void PersistenceWorker::workerLoop() {
+#ifdef ENABLE_TRACING
+    Trace::setThreadName("persistence");
+#endif
+
+    OdometerState latest = last_written;
+    bool dirty = false;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        // Wake on submit/flush/stop, and periodically for the time policy
+        wake.wait_for(lock, policy.max_interval, [this] {
+            return !running || flush_requested || has_pending || !jobs.empty();
+        });
+
+        // Take the newest snapshot - anything older was coalesced away
+        if (has_pending) {
+            latest = pending;
+            has_pending = false;
+            dirty = true;
+        }
+        bool stopping = !running;
+        bool forced = flush_requested || stopping;
+        flush_requested = false;
+
+        auto now = std::chrono::steady_clock::now();
+        if (dirty && (forced || shouldWrite(latest, now))) {
+            // Never hold the lock across the fdatasync - the UI thread submits.
+            // A failed write stays dirty and is retried on the next wake-up.
+            lock.unlock();
+            dirty = !write(latest, now);
+            lock.lock();
+        }
+
+        while (!jobs.empty()) {
+            std::function<void()> job = std::move(jobs.front());
+            jobs.pop_front();
+            lock.unlock();
+            job();
+            lock.lock();
+        }
+
+        if (stopping) break;
+    }
+}
@@ -0,0 +1,106 @@
+#include "PixelConvert.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PIXEL_CONVERT_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define PIXEL_CONVERT_SSE2
+#endif
+
+namespace {
+
+void convertScalar(const uint16_t* src, uint32_t* dst, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+        uint32_t px = src[i];
+        uint32_t r = px >> 11;
+        uint32_t g = (px >> 5) & 0x3F;
+        uint32_t b = px & 0x1F;
+        r = (r << 3) | (r >> 2);
+        g = (g << 2) | (g >> 4);
+        b = (b << 3) | (b >> 2);
+        dst[i] = 0xFF000000u | (r << 16) | (g << 8) | b;
+    }
+}
+
+#if defined(PIXEL_CONVERT_NEON)
+
+// Returns how many pixels were converted; the rest go through convertScalar
+size_t convertVector(const uint16_t* src, uint32_t* dst, size_t count) {
+    size_t blocks = count / 8;
+    const uint16x8_t mask6 = vdupq_n_u16(0x3F);
+    const uint16x8_t mask5 = vdupq_n_u16(0x1F);
+    const uint16x8_t alpha = vdupq_n_u16(0xFF00);
+
+    for (size_t b = 0; b < blocks; b++) {
+        uint16x8_t px = vld1q_u16(src + b * 8);
+        uint16x8_t r = vshrq_n_u16(px, 11);
+        uint16x8_t g = vandq_u16(vshrq_n_u16(px, 5), mask6);
+        uint16x8_t bl = vandq_u16(px, mask5);
+        r = vorrq_u16(vshlq_n_u16(r, 3), vshrq_n_u16(r, 2));
+        g = vorrq_u16(vshlq_n_u16(g, 2), vshrq_n_u16(g, 4));
+        bl = vorrq_u16(vshlq_n_u16(bl, 3), vshrq_n_u16(bl, 2));
+
+        // Little-endian XRGB8888 is B,G,R,A in memory: interleave (G<<8|B)
+        // with (A<<8|R) halfword by halfword
+        uint16x8x2_t out;
+        out.val[0] = vorrq_u16(vshlq_n_u16(g, 8), bl);
+        out.val[1] = vorrq_u16(alpha, r);
+        vst2q_u16((uint16_t*)(dst + b * 8), out);
+    }
+    return blocks * 8;
+}
+
+#elif defined(PIXEL_CONVERT_SSE2)
+
+size_t convertVector(const uint16_t* src, uint32_t* dst, size_t count) {
+    size_t blocks = count / 8;
+    const __m128i mask6 = _mm_set1_epi16(0x3F);
+    const __m128i mask5 = _mm_set1_epi16(0x1F);
+    const __m128i alpha = _mm_set1_epi16((short)0xFF00);
+
+    for (size_t b = 0; b < blocks; b++) {
+        __m128i px = _mm_loadu_si128((const __m128i*)(src + b * 8));
+        __m128i r = _mm_srli_epi16(px, 11);
+        __m128i g = _mm_and_si128(_mm_srli_epi16(px, 5), mask6);
+        __m128i bl = _mm_and_si128(px, mask5);
+        r = _mm_or_si128(_mm_slli_epi16(r, 3), _mm_srli_epi16(r, 2));
+        g = _mm_or_si128(_mm_slli_epi16(g, 2), _mm_srli_epi16(g, 4));
+        bl = _mm_or_si128(_mm_slli_epi16(bl, 3), _mm_srli_epi16(bl, 2));
+
+        __m128i gb = _mm_or_si128(_mm_slli_epi16(g, 8), bl);
+        __m128i ar = _mm_or_si128(alpha, r);
+        _mm_storeu_si128((__m128i*)(dst + b * 8), _mm_unpacklo_epi16(gb, ar));
+        _mm_storeu_si128((__m128i*)(dst + b * 8 + 4), _mm_unpackhi_epi16(gb, ar));
+    }
+    return blocks * 8;
+}
+
+#else
+
+size_t convertVector(const uint16_t*, uint32_t*, size_t) {
+    return 0;
+}
+
+#endif
+
+} // namespace
+
+namespace PixelConvert {
+
+const char* kernelName() {
+#if defined(PIXEL_CONVERT_NEON)
+    return "NEON";
+#elif defined(PIXEL_CONVERT_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+void rgb565ToXrgb8888(const uint16_t* src, uint32_t* dst, size_t count) {
+    size_t done = convertVector(src, dst, count);
+    convertScalar(src, dst, done, count);
+}
+
+} // namespace PixelConvert
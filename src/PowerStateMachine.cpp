@@ -0,0 +1,73 @@
+#include "PowerStateMachine.h"
+#include <algorithm>
+#include <cstdlib>
+
+// refresh, input, update, chart, audio poll - all ms
+const PowerProfile PowerStateMachine::PROFILES[POWER_STATE_COUNT] = {
+    {16, 5, 100, 16, 10000},        // POWER_DRIVING
+    {33, 16, 250, 100, 10000},      // POWER_PARKED
+    {100, 33, 1000, 1000, 30000},   // POWER_CHARGING
+    {100, 33, 1000, 1000, 30000},   // POWER_IGNITION_OFF
+    {0, 0, 5000, 0, 0},             // POWER_STANDBY
+};
+
+static const char* const STATE_NAMES[POWER_STATE_COUNT] = {
+    "driving", "parked", "charging", "ignition off", "standby"
+};
+
+PowerStateMachine::PowerStateMachine(PowerConfig config) : config(config) {
+}
+
+PowerConfig PowerStateMachine::configFromEnvironment() {
+    PowerConfig config;
+    const char* value = getenv("TAZZARI_STANDBY_MINUTES");
+    if (value && *value) {
+        long minutes = strtol(value, nullptr, 10);
+        // Longest timeout the uint32 milliseconds hold, about 49 days
+        long max_minutes = UINT32_MAX / 60000;
+        if (minutes >= 0) config.standby_after_ms = (uint32_t)std::min(minutes, max_minutes) * 60000;
+    }
+    return config;
+}
+
+const char* PowerStateMachine::stateName(PowerState state) {
+    return state < POWER_STATE_COUNT ? STATE_NAMES[state] : "?";
+}
+
+PowerState PowerStateMachine::classify(const PowerInputs& in) const {
+    bool stationary = !in.vehicle_live || in.speed_kmh < config.moving_kmh;
+    if (stationary && in.bms_live && in.current_a >= config.charge_current_a) return POWER_CHARGING;
+
+    if (!in.vehicle_live) {
+        if (config.standby_after_ms && in.idle_ms >= config.standby_after_ms) return POWER_STANDBY;
+        if (in.silent_ms >= config.ignition_off_ms) return POWER_IGNITION_OFF;
+        return state;   // Short dropout - keep what we had
+    }
+    if (in.speed_kmh >= config.moving_kmh) return POWER_DRIVING;
+    if (in.in_gear && !in.handbrake) return POWER_DRIVING;
+    return POWER_PARKED;
+}
+
+bool PowerStateMachine::update(const PowerInputs& inputs, uint64_t now_ms) {
+    PowerState next = classify(inputs);
+    if (next == state) {
+        pending = state;
+        return false;
+    }
+
+    // Waking up or pulling away is immediate; slowing down has to settle
+    bool immediate = next == POWER_DRIVING || state == POWER_STANDBY || state == POWER_IGNITION_OFF ||
+                     next == POWER_IGNITION_OFF || next == POWER_STANDBY;
+    if (!immediate) {
+        if (next != pending) {
+            pending = next;
+            pending_since = now_ms;
+            return false;
+        }
+        if (now_ms - pending_since < config.park_after_ms) return false;
+    }
+
+    state = next;
+    pending = next;
+    return true;
+}
@@ -0,0 +1,93 @@
+#include "RangeEstimator.h"
+#include <algorithm>
+#include <cstdlib>
+
+// Learning step and plausible consumption for one step
+static const double LEARN_STEP_KM = 1.0;
+static const double MIN_WH_PER_KM = 20.0;
+static const double MAX_WH_PER_KM = 400.0;
+
+// Blend weights, shortest window first, then the learned value
+static const double WINDOW_WEIGHTS[EnergyAccumulator::WINDOW_COUNT] = {0.2, 0.35, 0.25};
+static const double LEARNED_WEIGHT = 0.2;
+
+RangeEstimator::RangeEstimator(RangeConfig config)
+    : config(config) {
+}
+
+RangeConfig RangeEstimator::configFromEnvironment() {
+    RangeConfig config;
+    if (const char* kwh = std::getenv("TAZZARI_PACK_KWH")) {
+        double value = atof(kwh);
+        if (value > 0.0) config.pack_kwh = value;
+    }
+    return config;
+}
+
+void RangeEstimator::restoreLearned(double wh_per_km) {
+    if (wh_per_km >= MIN_WH_PER_KM && wh_per_km <= MAX_WH_PER_KM) {
+        learned_wh_per_km = wh_per_km;
+    }
+}
+
+double RangeEstimator::longTermWhPerKm() const {
+    return learned_wh_per_km > 0.0 ? learned_wh_per_km : config.default_wh_per_km;
+}
+
+void RangeEstimator::learn(const EnergyAccumulator& energy, double distance_km) {
+    double lifetime_wh = energy.getLifetime().netWh();
+    if (!learn_started) {
+        learn_start_wh = lifetime_wh;
+        learn_started = true;
+    }
+
+    learn_km += distance_km;
+    if (learn_km < LEARN_STEP_KM) return;
+
+    // Exponential average over distance; implausible steps (BMS dropout) are skipped
+    double step_wh_per_km = (lifetime_wh - learn_start_wh) / learn_km;
+    if (step_wh_per_km >= MIN_WH_PER_KM && step_wh_per_km <= MAX_WH_PER_KM) {
+        double alpha = std::min(1.0, learn_km / config.learn_distance_km);
+        double base = longTermWhPerKm();
+        learned_wh_per_km = base + (step_wh_per_km - base) * alpha;
+    }
+    learn_km = 0.0;
+    learn_start_wh = lifetime_wh;
+}
+
+void RangeEstimator::update(const EnergyAccumulator& energy, double distance_km, float soc_percent, bool soc_valid) {
+    learn(energy, distance_km);
+
+    if (!soc_valid) {
+        estimate.valid = false;
+        return;
+    }
+
+    double weight_sum = LEARNED_WEIGHT;
+    double long_term = longTermWhPerKm();
+    double weighted = long_term * LEARNED_WEIGHT;
+    double lowest = long_term;
+    double highest = long_term;
+
+    for (size_t i = 0; i < EnergyAccumulator::WINDOW_COUNT; i++) {
+        const RollingConsumption& window = energy.getWindow(i);
+        double coverage = std::min(1.0, window.getDistanceKm() / window.getWindowKm());
+        double wh_per_km = window.whPerKm();
+        if (coverage <= 0.0 || wh_per_km < MIN_WH_PER_KM || wh_per_km > MAX_WH_PER_KM) continue;
+
+        double weight = WINDOW_WEIGHTS[i] * coverage;
+        weighted += wh_per_km * weight;
+        weight_sum += weight;
+        lowest = std::min(lowest, wh_per_km);
+        highest = std::max(highest, wh_per_km);
+    }
+
+    double usable_percent = std::max(0.0, (double)soc_percent - config.reserve_percent);
+    double usable_wh = config.pack_kwh * 1000.0 * usable_percent / 100.0;
+
+    estimate.valid = true;
+    estimate.wh_per_km = weighted / weight_sum;
+    estimate.km = usable_wh / estimate.wh_per_km;
+    estimate.low_km = usable_wh / highest;
+    estimate.high_km = usable_wh / lowest;
+}
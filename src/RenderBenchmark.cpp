@@ -0,0 +1,67 @@
+#include "RenderBenchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+RenderBenchmark::RenderBenchmark(lv_display_t* display) : display(display) {
+    lv_display_add_event_cb(display, invalidateEvent, LV_EVENT_INVALIDATE_AREA, this);
+}
+
+uint32_t RenderBenchmark::framesFromEnvironment() {
+    const char* env = std::getenv("TAZZARI_RENDER_BENCH");
+    if (!env) return 0;
+    long frames = std::strtol(env, nullptr, 10);
+    return frames > 0 ? (uint32_t)frames : 0;
+}
+
+void RenderBenchmark::addScene(const std::string& name, Step step) {
+    scenes.push_back({name, std::move(step)});
+}
+
+// Areas overlapping within a frame count twice - an upper bound on what
+// LVGL actually redraws after joining them
+void RenderBenchmark::invalidateEvent(lv_event_t* e) {
+    RenderBenchmark* self = (RenderBenchmark*)lv_event_get_user_data(e);
+    const lv_area_t* area = (const lv_area_t*)lv_event_get_param(e);
+    if (area) self->invalidated_pixels += lv_area_get_size(area);
+}
+
+void RenderBenchmark::run(uint32_t frames, std::ostream& out) {
+    if (frames == 0) return;
+
+    uint32_t bytes_per_pixel = lv_color_format_get_size(lv_display_get_color_format(display));
+    char line[160];
+    std::snprintf(line, sizeof(line), "RenderBenchmark: %u frames per scene, %u bytes/pixel", frames, bytes_per_pixel);
+    out << line << "\n";
+    std::snprintf(line, sizeof(line), "%-16s %9s %9s %9s %9s %10s %9s",
+                  "scene", "mean ms", "p95 ms", "p99 ms", "max ms", "KB/frame", "MB/s");
+    out << line << "\n";
+
+    std::vector<double> times(frames);
+    for (const Scene& scene : scenes) {
+        // Start every scene from a settled screen
+        lv_refr_now(display);
+        invalidated_pixels = 0;
+
+        for (uint32_t frame = 0; frame < frames; frame++) {
+            auto start = std::chrono::steady_clock::now();
+            scene.step(frame);
+            lv_refr_now(display);
+            times[frame] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        double total_ms = 0.0;
+        for (double t : times) total_ms += t;
+        std::vector<double> sorted = times;
+        std::sort(sorted.begin(), sorted.end());
+
+        double kb_per_frame = (double)invalidated_pixels * bytes_per_pixel / frames / 1024.0;
+        double mb_per_s = total_ms > 0.0 ? invalidated_pixels * bytes_per_pixel / (total_ms * 1000.0) : 0.0;
+        std::snprintf(line, sizeof(line), "%-16s %9.2f %9.2f %9.2f %9.2f %10.1f %9.1f",
+                      scene.name.c_str(), total_ms / frames, sorted[frames * 95 / 100], sorted[frames * 99 / 100],
+                      sorted.back(), kb_per_frame, mb_per_s);
+        out << line << "\n";
+    }
+    out.flush();
+}
@@ -0,0 +1,165 @@
+#include "ScreenManager.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// ---- LazyScreen ----
+
+void LazyScreen::setLabelText(lv_obj_t* label, const char* text) {
+    if (strcmp(lv_label_get_text(label), text) != 0) {
+        lv_label_set_text(label, text);
+    }
+}
+
+lv_obj_t* LazyScreen::createLabel(lv_obj_t* parent, const lv_font_t* font, int32_t x, int32_t y) {
+    lv_obj_t* label = lv_label_create(parent);
+    lv_obj_set_style_text_font(label, font, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_color(label, lv_color_hex(0xffffff), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_pos(label, x, y);
+    lv_label_set_text(label, "");
+    return label;
+}
+
+lv_obj_t* LazyScreen::createScreen(const char* title) {
+    lv_obj_t* screen = lv_obj_create(NULL);
+    lv_obj_set_style_bg_color(screen, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_clear_flag(screen, LV_OBJ_FLAG_SCROLLABLE);
+    lv_label_set_text(createLabel(screen, &lv_font_montserrat_24, 20, 14), title);
+    return screen;
+}
+
+// ---- ScreenManager ----
+
+ScreenManager::ScreenManager(size_t budget_bytes) : budget(budget_bytes) {
+}
+
+size_t ScreenManager::budgetFromEnvironment() {
+    const char* value = getenv("TAZZARI_SCREEN_BUDGET_KB");
+    if (value && *value) {
+        long kb = strtol(value, nullptr, 10);
+        if (kb >= 0) return (size_t)kb * 1024;
+    }
+    return DEFAULT_BUDGET;
+}
+
+void ScreenManager::setHome(lv_obj_t* screen) {
+    home = screen;
+    lv_obj_add_event_cb(home, gestureEvent, LV_EVENT_GESTURE, this);
+}
+
+void ScreenManager::add(LazyScreen* screen) {
+    screen->manager = this;
+    Entry entry;
+    entry.screen = screen;
+    entries.push_back(entry);
+}
+
+size_t ScreenManager::heapUsed() {
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    return mon.total_size - mon.free_size;
+}
+
+void ScreenManager::build(Entry& entry) {
+    size_t before = heapUsed();
+    entry.obj = entry.screen->build();
+    size_t after = heapUsed();
+    entry.bytes = after > before ? after - before : 0;
+    lv_obj_add_event_cb(entry.obj, gestureEvent, LV_EVENT_GESTURE, this);
+
+    std::cout << "Screens: Built " << entry.screen->getName() << " (" << entry.bytes / 1024 << " KB)" << std::endl;
+}
+
+lv_obj_t* ScreenManager::objectAt(size_t index) {
+    if (index == 0) return home;
+    Entry& entry = entries[index - 1];
+    if (!entry.obj) build(entry);
+    entry.last_shown = ++show_count;
+    return entry.obj;
+}
+
+void ScreenManager::show(size_t index) {
+    if (index >= getScreenCount() || index == current) return;
+
+    lv_obj_t* outgoing = lv_screen_active();
+    lv_screen_load_anim_t anim = index > current ? LV_SCR_LOAD_ANIM_MOVE_LEFT : LV_SCR_LOAD_ANIM_MOVE_RIGHT;
+    current = index;
+    lv_obj_t* target = objectAt(index);
+    tick(last_tick_ms);
+    lv_screen_load_anim(target, anim, ANIM_MS, 0, false);
+
+    evict(outgoing);
+}
+
+void ScreenManager::show(LazyScreen* screen) {
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].screen == screen) {
+            show(i + 1);
+            return;
+        }
+    }
+}
+
+void ScreenManager::showNext() {
+    if (current + 1 < getScreenCount()) show(current + 1);
+}
+
+void ScreenManager::showPrevious() {
+    if (current > 0) show(current - 1);
+}
+
+// Least recently shown first; never the incoming screen, nor the last two
+// shown, which may still be sliding out
+void ScreenManager::evict(lv_obj_t* outgoing) {
+    while (getResidentBytes() > budget) {
+        Entry* oldest = nullptr;
+        for (size_t i = 0; i < entries.size(); i++) {
+            Entry& entry = entries[i];
+            if (!entry.obj || i + 1 == current || entry.obj == outgoing) continue;
+            if (entry.last_shown + 2 > show_count) continue;
+            if (!oldest || entry.last_shown < oldest->last_shown) oldest = &entry;
+        }
+        if (!oldest) return;
+
+        lv_obj_delete(oldest->obj);
+        oldest->obj = nullptr;
+        oldest->bytes = 0;
+        oldest->screen->release();
+        std::cout << "Screens: Released " << oldest->screen->getName() << std::endl;
+    }
+}
+
+void ScreenManager::tick(uint64_t now_ms) {
+    last_tick_ms = now_ms;
+    if (current == 0) return;
+    Entry& entry = entries[current - 1];
+    if (entry.obj) entry.screen->tick(now_ms);
+}
+
+bool ScreenManager::isShown(const LazyScreen* screen) const {
+    return current > 0 && entries[current - 1].screen == screen;
+}
+
+size_t ScreenManager::getResidentBytes() const {
+    size_t total = 0;
+    for (const Entry& entry : entries) total += entry.bytes;
+    return total;
+}
+
+size_t ScreenManager::getResidentCount() const {
+    size_t count = 0;
+    for (const Entry& entry : entries) {
+        if (entry.obj) count++;
+    }
+    return count;
+}
+
+void ScreenManager::gestureEvent(lv_event_t* e) {
+    ScreenManager* self = (ScreenManager*)lv_event_get_user_data(e);
+    lv_dir_t dir = lv_indev_get_gesture_dir(lv_indev_active());
+    if (dir == LV_DIR_LEFT) {
+        self->showNext();
+    } else if (dir == LV_DIR_RIGHT) {
+        self->showPrevious();
+    }
+}
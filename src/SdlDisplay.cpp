@@ -0,0 +1,221 @@
+#include "SdlDisplay.h"
+#include "PixelConvert.h"
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+// ---- SdlDisplayConfig ----
+
+SdlDisplayConfig SdlDisplayConfig::fromEnvironment() {
+    SdlDisplayConfig config;
+    if (const char* mode = std::getenv("TAZZARI_RENDER_MODE")) {
+        if (strcmp(mode, "direct") == 0) {
+            config.render_mode = LV_DISPLAY_RENDER_MODE_DIRECT;
+        } else if (strcmp(mode, "full") == 0) {
+            config.render_mode = LV_DISPLAY_RENDER_MODE_FULL;
+        } else if (strcmp(mode, "partial") != 0) {
+            std::cerr << "SdlDisplay: Unknown TAZZARI_RENDER_MODE '" << mode << "', using partial" << std::endl;
+        }
+    }
+    if (const char* lines = std::getenv("TAZZARI_DRAW_BUF_LINES")) {
+        config.buffer_lines = std::max(1, atoi(lines));
+    }
+    if (const char* count = std::getenv("TAZZARI_DRAW_BUF_COUNT")) {
+        config.buffer_count = atoi(count) == 1 ? 1 : 2;
+    }
+    return config;
+}
+
+const char* SdlDisplayConfig::renderModeName() const {
+    switch (render_mode) {
+        case LV_DISPLAY_RENDER_MODE_DIRECT: return "direct";
+        case LV_DISPLAY_RENDER_MODE_FULL:   return "full";
+        default:                            return "partial";
+    }
+}
+
+// ---- SdlDisplay ----
+
+SdlDisplay::~SdlDisplay() {
+    if (event_timer) lv_timer_delete(event_timer);
+    if (texture) SDL_DestroyTexture(texture);
+    if (renderer) SDL_DestroyRenderer(renderer);
+    if (window) SDL_DestroyWindow(window);
+}
+
+lv_display_t* SdlDisplay::create(int32_t width, int32_t height, bool fullscreen, const SdlDisplayConfig& cfg) {
+    config = cfg;
+
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        std::cerr << "SdlDisplay: SDL_Init failed: " << SDL_GetError() << std::endl;
+        return nullptr;
+    }
+
+    window = SDL_CreateWindow("Tazzari", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, width, height,
+                              fullscreen ? SDL_WINDOW_FULLSCREEN_DESKTOP : 0);
+    renderer = window ? SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED) : nullptr;
+    if (!renderer) {
+        std::cerr << "SdlDisplay: Cannot open window: " << SDL_GetError() << std::endl;
+        return nullptr;
+    }
+    // Fullscreen on a different panel size scales the 1024x600 frame
+    SDL_RenderSetLogicalSize(renderer, width, height);
+#ifdef DEPLOYMENT_BUILD
+    SDL_ShowCursor(SDL_DISABLE);
+#endif
+
+    SDL_RendererInfo info;
+    if (SDL_GetRendererInfo(renderer, &info) != 0) {
+        info.name = "unknown";
+        info.num_texture_formats = 0;
+    }
+
+    // SDL_PIXELFORMAT_RGB888 is XRGB8888
+    Uint32 texture_format = SDL_PIXELFORMAT_RGB888;
+#if LV_COLOR_DEPTH == 16
+    color_format = LV_COLOR_FORMAT_RGB565;
+    converting = true;
+    for (Uint32 i = 0; i < info.num_texture_formats; i++) {
+        if (info.texture_formats[i] == SDL_PIXELFORMAT_RGB565) converting = false;
+    }
+    if (!converting) texture_format = SDL_PIXELFORMAT_RGB565;
+#else
+    color_format = LV_COLOR_FORMAT_XRGB8888;
+    converting = false;
+#endif
+    texture = SDL_CreateTexture(renderer, texture_format, SDL_TEXTUREACCESS_STREAMING, width, height);
+    if (!texture) {
+        std::cerr << "SdlDisplay: Cannot create texture: " << SDL_GetError() << std::endl;
+        return nullptr;
+    }
+
+    // Partial: a band of lines; direct/full: the whole screen
+    screen_stride = lv_draw_buf_width_to_stride(width, color_format);
+    int32_t lines = config.render_mode == LV_DISPLAY_RENDER_MODE_PARTIAL ? std::min(config.buffer_lines, height) : height;
+    size_t buffer_size = (size_t)screen_stride * lines;
+    draw_buf_1.resize(buffer_size);
+    if (config.buffer_count == 2) draw_buf_2.resize(buffer_size);
+    if (converting) converted.resize((size_t)width * lines);
+
+    std::cout << "SdlDisplay: " << LV_COLOR_DEPTH << "-bit on " << info.name << ", " << config.renderModeName()
+              << " mode, " << config.buffer_count << " x " << buffer_size / 1024 << " KB buffers, "
+              << LV_DRAW_SW_DRAW_UNIT_CNT << " draw unit(s)";
+    if (converting) std::cout << ", converted to XRGB8888 (" << PixelConvert::kernelName() << ")";
+    std::cout << std::endl;
+
+    lv_tick_set_cb(SDL_GetTicks);
+
+    display = lv_display_create(width, height);
+    lv_display_set_color_format(display, color_format);
+    lv_display_set_buffers(display, draw_buf_1.data(), draw_buf_2.empty() ? nullptr : draw_buf_2.data(),
+                           buffer_size, config.render_mode);
+    lv_display_set_flush_cb(display, flushCallback);
+    lv_display_set_driver_data(display, this);
+
+    pointer = lv_indev_create();
+    lv_indev_set_type(pointer, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_read_cb(pointer, pointerRead);
+    lv_indev_set_driver_data(pointer, this);
+    lv_indev_set_display(pointer, display);
+
+    event_timer = lv_timer_create(pollEvents, 5, this);
+    return display;
+}
+
+void SdlDisplay::setTimerPeriods(uint32_t refresh_ms, uint32_t input_ms) {
+    if (!display) return;
+    lv_timer_t* timers[] = {lv_display_get_refr_timer(display), lv_indev_get_read_timer(pointer)};
+    uint32_t periods[] = {refresh_ms, input_ms};
+    for (int i = 0; i < 2; i++) {
+        if (refresh_ms == 0) {
+            lv_timer_pause(timers[i]);
+        } else {
+            lv_timer_set_period(timers[i], periods[i]);
+            lv_timer_resume(timers[i]);
+        }
+    }
+    lv_timer_set_period(event_timer, refresh_ms == 0 ? STANDBY_EVENT_MS : input_ms);
+}
+
+bool SdlDisplay::takeActivity() {
+    bool was_active = activity;
+    activity = false;
+    return was_active;
+}
+
+void SdlDisplay::flushCallback(lv_display_t* disp, const lv_area_t* area, uint8_t* px_map) {
+    SdlDisplay* self = (SdlDisplay*)lv_display_get_driver_data(disp);
+    self->flush(disp, area, px_map);
+}
+
+void SdlDisplay::flush(lv_display_t* disp, const lv_area_t* area, uint8_t* px_map) {
+    int32_t w = lv_area_get_width(area);
+    int32_t h = lv_area_get_height(area);
+    SDL_Rect rect = {area->x1, area->y1, w, h};
+
+    // Partial buffers hold just the area; direct/full ones the whole screen
+    const uint8_t* pixels = px_map;
+    uint32_t stride = lv_draw_buf_width_to_stride(w, color_format);
+    if (config.render_mode != LV_DISPLAY_RENDER_MODE_PARTIAL) {
+        stride = screen_stride;
+        pixels = px_map + (size_t)area->y1 * stride + (size_t)area->x1 * lv_color_format_get_size(color_format);
+    }
+
+    if (converting) {
+        for (int32_t y = 0; y < h; y++) {
+            PixelConvert::rgb565ToXrgb8888((const uint16_t*)(pixels + (size_t)y * stride), &converted[(size_t)y * w], w);
+        }
+        SDL_UpdateTexture(texture, &rect, converted.data(), w * sizeof(uint32_t));
+    } else {
+        SDL_UpdateTexture(texture, &rect, pixels, stride);
+    }
+
+    if (lv_display_flush_is_last(disp)) {
+        SDL_RenderCopy(renderer, texture, nullptr, nullptr);
+        SDL_RenderPresent(renderer);
+    }
+    lv_display_flush_ready(disp);
+}
+
+void SdlDisplay::pointerRead(lv_indev_t* indev, lv_indev_data_t* data) {
+    SdlDisplay* self = (SdlDisplay*)lv_indev_get_driver_data(indev);
+    data->point.x = self->pointer_x;
+    data->point.y = self->pointer_y;
+    data->state = self->pointer_pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+}
+
+// Touch arrives as SDL's synthetic mouse events, already in logical coordinates
+void SdlDisplay::pollEvents(lv_timer_t* timer) {
+    SdlDisplay* self = (SdlDisplay*)lv_timer_get_user_data(timer);
+    SDL_Event event;
+    while (SDL_PollEvent(&event)) {
+        switch (event.type) {
+            case SDL_MOUSEMOTION:
+                self->pointer_x = event.motion.x;
+                self->pointer_y = event.motion.y;
+                break;
+            case SDL_MOUSEBUTTONDOWN:
+            case SDL_MOUSEBUTTONUP:
+                if (event.button.button != SDL_BUTTON_LEFT) break;
+                self->pointer_x = event.button.x;
+                self->pointer_y = event.button.y;
+                self->pointer_pressed = event.type == SDL_MOUSEBUTTONDOWN;
+                self->activity |= self->pointer_pressed;
+                break;
+            case SDL_WINDOWEVENT:
+                if (event.window.event == SDL_WINDOWEVENT_EXPOSED) {
+                    lv_obj_invalidate(lv_display_get_screen_active(self->display));
+                }
+                break;
+            case SDL_QUIT:
+                std::raise(SIGTERM);
+                break;
+            default:
+                break;
+        }
+    }
+}
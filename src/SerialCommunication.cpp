@@ -1,6 +1,8 @@
 #include "SerialCommunication.h"
+#include "Trace.h"
 #include <iostream>
 #include <fcntl.h>
+#include <poll.h>
 #include <termios.h>
 #include <unistd.h>
 #include <cstring>
@@ -12,6 +14,13 @@ SerialCommunication::SerialCommunication(const char* port, int baud)
     auto now = std::chrono::steady_clock::now();
     last_auto_time = now;
     last_bms_time = now;
+    
+    decoder.setPacketCallback([this](uint8_t type, const uint8_t* payload, uint8_t length) {
+        handleReceivedPacket(type, payload, length);
+    });
+    decoder.setErrorCallback([this](PacketError error) {
+        handlePacketError(error);
+    });
 }
 
 SerialCommunication::~SerialCommunication() {
@@ -90,21 +99,28 @@ uint32_t SerialCommunication::getCurrentTimeMs() {
     return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
 }
 
-uint8_t SerialCommunication::calculateChecksum(uint8_t* data, size_t length) {
-    uint8_t checksum = 0;
-    for (size_t i = 0; i < length; i++) {
-        checksum ^= data[i];
+void SerialCommunication::handlePacketError(PacketError error) {
+    if (error == PACKET_ERROR_CHECKSUM) {
+        std::cout << "Serial: Checksum mismatch!" << std::endl;
+        stats.checksum_errors.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        stats.framing_errors.fetch_add(1, std::memory_order_relaxed);
     }
-    return checksum;
 }
 
 void SerialCommunication::processData() {
     if (serial_fd < 0) return;
     
     uint8_t buffer[256];
-    ssize_t bytes_read = read(serial_fd, buffer, sizeof(buffer));
+    ssize_t bytes_read;
+    {
+        TRACE_SCOPE("serial_read");
+        bytes_read = read(serial_fd, buffer, sizeof(buffer));
+    }
     
     if (bytes_read > 0) {
+        TRACE_SCOPE("serial_decode");
+        stats.bytes_received.fetch_add(bytes_read, std::memory_order_relaxed);
         static uint32_t last_debug = 0;
         uint32_t current_time = getCurrentTimeMs();
         if (current_time - last_debug > 5000) {
@@ -112,74 +128,15 @@ void SerialCommunication::processData() {
             last_debug = current_time;
         }
         
-        for (ssize_t i = 0; i < bytes_read; i++) {
-            uint8_t byte = buffer[i];
-            
-            switch (packet_state) {
-                case 0: // Waiting for start byte
-                    if (byte == PACKET_START_BYTE) {
-                        packet_state = 1;
-                    }
-                    break;
-                    
-                case 1: // Got start byte, waiting for packet type
-                    if (byte == BMS_PACKET_TYPE || byte == AUTO_PACKET_TYPE) {
-                        packet_type = byte;
-                        packet_state = 2;
-                    } else {
-                        packet_state = 0;
-                    }
-                    break;
-                    
-                case 2: // Got type, waiting for length
-                    packet_length = byte;
-                    if (packet_length > 0 && packet_length <= sizeof(packet_buffer)) {
-                        data_index = 0;
-                        packet_state = 3;
-                    } else {
-                        packet_state = 0;
-                    }
-                    break;
-                    
-                case 3: // Reading data
-                    packet_buffer[data_index++] = byte;
-                    if (data_index >= packet_length) {
-                        packet_state = 4;
-                    }
-                    break;
-                    
-                case 4: { // Reading checksum
-                    uint8_t checksum_data[packet_length + 2];
-                    checksum_data[0] = packet_type;
-                    checksum_data[1] = packet_length;
-                    memcpy(&checksum_data[2], packet_buffer, packet_length);
-                    uint8_t calculated = calculateChecksum(checksum_data, sizeof(checksum_data));
-                    
-                    if (byte == calculated) {
-                        packet_state = 5;
-                    } else {
-                        std::cout << "Serial: Checksum mismatch!" << std::endl;
-                        packet_state = 0;
-                    }
-                    break;
-                }
-                    
-                case 5: // Checking end byte
-                    if (byte == PACKET_END_BYTE) {
-                        handleReceivedPacket();
-                    }
-                    packet_state = 0;
-                    break;
-            }
-        }
+        decoder.feed(buffer, bytes_read);
     }
 }
 
-void SerialCommunication::handleReceivedPacket() {
+void SerialCommunication::handleReceivedPacket(uint8_t packet_type, const uint8_t* payload, uint8_t packet_length) {
     auto now = std::chrono::steady_clock::now();
     
-    if (packet_type == BMS_PACKET_TYPE && packet_length == sizeof(bms_data_t)) {
-        memcpy(&received_bms_data, packet_buffer, sizeof(bms_data_t));
+    if (packet_type == BMS_PACKET_TYPE && PacketDecoder::decodeBMS(payload, packet_length, received_bms_data)) {
+        stats.bms_packets.fetch_add(1, std::memory_order_relaxed);
         new_bms_data = true;
         last_bms_time = now;
         
@@ -196,8 +153,8 @@ void SerialCommunication::handleReceivedPacket() {
             last_debug = current_time;
         }
         
-    } else if (packet_type == AUTO_PACKET_TYPE && packet_length == sizeof(automotive_data_t)) {
-        memcpy(&received_auto_data, packet_buffer, sizeof(automotive_data_t));
+    } else if (packet_type == AUTO_PACKET_TYPE && PacketDecoder::decodeAutomotive(payload, packet_length, received_auto_data)) {
+        stats.auto_packets.fetch_add(1, std::memory_order_relaxed);
         new_auto_data = true;
         last_auto_time = now;
         
@@ -212,6 +169,15 @@ void SerialCommunication::handleReceivedPacket() {
                      << "Gear:" << (received_auto_data.reverse ? "R" : (received_auto_data.forward ? "D" : "N")) << std::endl;
             last_debug = current_time;
         }
+    } else if (packet_type == CELL_PACKET_TYPE && PacketDecoder::decodeCells(payload, packet_length, received_cell_data)) {
+        stats.cell_packets.fetch_add(1, std::memory_order_relaxed);
+        
+        if (cell_callback) {
+            cell_callback(received_cell_data);
+        }
+    } else {
+        // Valid frame but payload size doesn't match the type - struct layout mismatch with ESP32
+        stats.framing_errors.fetch_add(1, std::memory_order_relaxed);
     }
 }
 
@@ -237,10 +203,24 @@ bool SerialCommunication::isBMSDataValid(int timeout_ms) {
     return elapsed <= timeout_ms && last_bms_time != std::chrono::steady_clock::time_point{};
 }
 
+bool SerialCommunication::waitForData(int timeout_ms) {
+    if (serial_fd < 0) {
+        usleep(timeout_ms * 1000);
+        return false;
+    }
+    struct pollfd pfd = {serial_fd, POLLIN, 0};
+    int result = poll(&pfd, 1, timeout_ms);
+    return result > 0 && (pfd.revents & POLLIN);
+}
+
 void SerialCommunication::setAutomotiveDataCallback(std::function<void(const automotive_data_t&)> callback) {
     auto_callback = callback;
 }
 
 void SerialCommunication::setBMSDataCallback(std::function<void(const bms_data_t&)> callback) {
     bms_callback = callback;
+}
+
+void SerialCommunication::setCellDataCallback(std::function<void(const cell_data_t&)> callback) {
+    cell_callback = callback;
 }
\ No newline at end of file
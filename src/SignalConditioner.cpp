@@ -0,0 +1,122 @@
+#include "SignalConditioner.h"
+#include <algorithm>
+#include <cmath>
+
+// ---- SignalFilter ----
+
+SignalFilter::SignalFilter(SignalFilterConfig config) : config(config) {
+    this->config.median = std::min(std::max(config.median, 1), MAX_MEDIAN);
+}
+
+int32_t SignalFilter::toFixed(float value) {
+    // +-32767 covers every signal here (km/h, A, %)
+    value = std::min(std::max(value, -32767.0f), 32767.0f);
+    return (int32_t)lrintf(value * 65536.0f);
+}
+
+void SignalFilter::reset() {
+    has_value = false;
+    filtered = 0;
+    slope = 0.0f;
+    display = 0.0f;
+    window_used = 0;
+    window_next = 0;
+}
+
+int32_t SignalFilter::median(int32_t sample) {
+    window[window_next] = sample;
+    window_next = (window_next + 1) % config.median;
+    if (window_used < config.median) window_used++;
+    if (window_used == 1) return sample;
+
+    // N <= 7: insertion sort of a copy beats anything clever
+    int32_t sorted[MAX_MEDIAN];
+    for (int i = 0; i < window_used; i++) {
+        int32_t v = window[i];
+        int j = i;
+        while (j > 0 && sorted[j - 1] > v) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = v;
+    }
+    return sorted[window_used / 2];
+}
+
+float SignalFilter::update(float value, uint32_t timestamp_ms) {
+    int32_t sample = toFixed(value);
+
+    // Unsigned difference handles the ESP32 millis() wrap
+    uint32_t dt_ms = timestamp_ms - last_timestamp;
+    if (!has_value || dt_ms > MAX_GAP_MS) {
+        reset();
+        median(sample);
+        filtered = sample;
+        has_value = true;
+        last_timestamp = timestamp_ms;
+        updateDisplay(true);
+        return getValue();
+    }
+    last_timestamp = timestamp_ms;
+
+    int32_t input = median(sample);
+    if (dt_ms == 0) {
+        return getValue();
+    }
+
+    int32_t previous = filtered;
+    int32_t next = input;
+    if (config.tau_ms > 0) {
+        int64_t alpha = ((int64_t)dt_ms << 16) / (config.tau_ms + dt_ms);
+        next = previous + (int32_t)(((int64_t)(input - previous) * alpha) >> 16);
+    }
+    if (config.max_rate > 0.0f) {
+        int32_t max_step = toFixed(config.max_rate * dt_ms / 1000.0f);
+        next = std::min(std::max(next, previous - max_step), previous + max_step);
+    }
+
+    filtered = next;
+    slope = fromFixed(next - previous) * 1000.0f / dt_ms;
+    updateDisplay(false);
+    return getValue();
+}
+
+void SignalFilter::updateDisplay(bool first) {
+    float value = getValue();
+    float step = config.display_step;
+    if (step <= 0.0f) {
+        display = value;
+        return;
+    }
+
+    float limit = step * (0.5f + config.display_hysteresis);
+    if (first || std::fabs(value - display) > limit) {
+        display = std::round(value / step) * step;
+    }
+}
+
+// ---- SignalConditioner ----
+
+SignalConditioner::SignalConditioner(SignalConditionerConfig config)
+    : speed(config.speed),
+      soc(config.soc),
+      acceleration(SignalFilterConfig{1, config.acceleration_tau_ms, 0.0f, 0.1f, 0.25f}) {
+}
+
+void SignalConditioner::addSpeed(float kmh, uint32_t timestamp_ms) {
+    speed.update(kmh, timestamp_ms);
+    acceleration.update(speed.getSlope() / 3.6f, timestamp_ms);
+}
+
+void SignalConditioner::addSoc(float percent, uint32_t timestamp_ms) {
+    soc.update(percent, timestamp_ms);
+}
+
+void SignalConditioner::resetSpeed() {
+    speed.reset();
+    acceleration.reset();
+}
+
+void SignalConditioner::resetBattery() {
+    soc.reset();
+}
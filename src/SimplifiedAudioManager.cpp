@@ -1,4 +1,5 @@
 #include "SimplifiedAudioManager.h"
+#include "Trace.h"
 #include <iostream>
 #include <cstdlib>
 #include <sstream>
@@ -81,6 +82,7 @@ void SimplifiedAudioManager::shutdown() {
 
 bool SimplifiedAudioManager::makeRestApiCall(const std::string& method, const std::string& endpoint, 
                                               const std::string& data, std::string* response) {
+    TRACE_SCOPE("audio_rest_call");
     CURL* curl = curl_easy_init();
     if (!curl) return false;
     
@@ -103,9 +105,15 @@ bool SimplifiedAudioManager::makeRestApiCall(const std::string& method, const st
         }
     }
     
+    auto call_start = std::chrono::steady_clock::now();
     CURLcode res = curl_easy_perform(curl);
     curl_easy_cleanup(curl);
     
+    rest_latency.observeSince(call_start);
+    if (res != CURLE_OK) {
+        rest_failures.fetch_add(1, std::memory_order_relaxed);
+    }
+    
     if (res == CURLE_OK && response) {
         *response = response_buffer;
     }
@@ -459,10 +467,10 @@ void SimplifiedAudioManager::setStateCallback(std::function<void(const SimpleMed
 
 void SimplifiedAudioManager::update() {
     auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - last_update).count();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_update).count();
     
-    // Update every 10 seconds to reduce system load
-    if (elapsed < 10) return;
+    // Update every 10 seconds (power state dependent) to reduce system load
+    if (elapsed < (int64_t)poll_interval_ms) return;
     
     last_update = now;
     
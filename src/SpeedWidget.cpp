@@ -0,0 +1,136 @@
+#include "SpeedWidget.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+static const char* const DIGIT_TEXT[10] = {"0", "1", "2", "3", "4", "5", "6", "7", "8", "9"};
+
+void SpeedWidget::attach(lv_obj_t* label) {
+    const lv_font_t* font = lv_obj_get_style_text_font(label, LV_PART_MAIN);
+    color = lv_obj_get_style_text_color(label, LV_PART_MAIN);
+    rasterize(font);
+
+    // Same alignment and offset as the EEZ label, which stays hidden
+    obj = lv_obj_create(lv_obj_get_parent(label));
+    lv_obj_remove_style_all(obj);
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_size(obj, cell_w * MAX_DIGITS, cell_h);
+    lv_obj_align(obj, lv_obj_get_style_align(label, LV_PART_MAIN),
+                 lv_obj_get_style_x(label, LV_PART_MAIN), lv_obj_get_style_y(label, LV_PART_MAIN));
+    lv_obj_add_event_cb(obj, drawEvent, LV_EVENT_DRAW_MAIN, this);
+    lv_obj_add_flag(label, LV_OBJ_FLAG_HIDDEN);
+
+    std::cout << "SpeedWidget: " << cell_w << "x" << cell_h << " digit atlas, " << atlas.size() << " bytes" << std::endl;
+}
+
+// Draw each digit centred in its cell on a throwaway ARGB8888 canvas and
+// keep only the coverage
+void SpeedWidget::rasterize(const lv_font_t* font) {
+    cell_w = 0;
+    for (int d = 0; d < 10; d++) {
+        cell_w = std::max<int32_t>(cell_w, lv_font_get_glyph_width(font, '0' + d, 0));
+    }
+    cell_h = lv_font_get_line_height(font);
+
+    uint32_t canvas_stride = lv_draw_buf_width_to_stride(cell_w, LV_COLOR_FORMAT_ARGB8888);
+    std::vector<uint8_t> canvas_buf((size_t)canvas_stride * cell_h * 10);
+
+    lv_obj_t* canvas = lv_canvas_create(lv_layer_top());
+    lv_canvas_set_buffer(canvas, canvas_buf.data(), cell_w, cell_h * 10, LV_COLOR_FORMAT_ARGB8888);
+    lv_canvas_fill_bg(canvas, lv_color_black(), LV_OPA_TRANSP);
+
+    lv_layer_t layer;
+    lv_canvas_init_layer(canvas, &layer);
+    for (int d = 0; d < 10; d++) {
+        lv_draw_label_dsc_t label_dsc;
+        lv_draw_label_dsc_init(&label_dsc);
+        label_dsc.font = font;
+        label_dsc.color = lv_color_white();
+        label_dsc.align = LV_TEXT_ALIGN_CENTER;
+        label_dsc.text = DIGIT_TEXT[d];
+
+        lv_area_t area = {0, d * cell_h, cell_w - 1, (d + 1) * cell_h - 1};
+        lv_draw_label(&layer, &label_dsc, &area);
+    }
+    lv_canvas_finish_layer(canvas, &layer);
+
+    atlas.assign((size_t)cell_w * cell_h * 10, 0);
+    for (int32_t y = 0; y < cell_h * 10; y++) {
+        const uint8_t* row = canvas_buf.data() + (size_t)y * canvas_stride;
+        for (int32_t x = 0; x < cell_w; x++) {
+            atlas[(size_t)y * cell_w + x] = row[x * 4 + 3];
+        }
+    }
+    lv_obj_delete(canvas);
+
+    for (int d = 0; d < 10; d++) {
+        lv_image_dsc_t& image = digit_images[d];
+        memset(&image, 0, sizeof(image));
+        image.header.magic = LV_IMAGE_HEADER_MAGIC;
+        image.header.cf = LV_COLOR_FORMAT_A8;
+        image.header.w = cell_w;
+        image.header.h = cell_h;
+        image.header.stride = cell_w;
+        image.data_size = cell_w * cell_h;
+        image.data = atlas.data() + (size_t)d * cell_w * cell_h;
+    }
+}
+
+void SpeedWidget::cellArea(int index, lv_area_t& area) const {
+    lv_area_t coords;
+    lv_obj_get_coords(obj, &coords);
+    area.x1 = coords.x1 + (MAX_DIGITS - shown_count) * cell_w / 2 + index * cell_w;
+    area.y1 = coords.y1;
+    area.x2 = area.x1 + cell_w - 1;
+    area.y2 = area.y1 + cell_h - 1;
+}
+
+void SpeedWidget::setValue(int speed) {
+    if (!obj) return;
+
+    int digits[MAX_DIGITS];
+    int count = 0;
+    if (speed >= 0) {
+        speed = std::min(speed, 999);
+        char text[8];
+        count = snprintf(text, sizeof(text), "%d", speed);
+        for (int i = 0; i < count; i++) digits[i] = text[i] - '0';
+    }
+
+    if (count != shown_count) {
+        // Digits move when the count changes
+        std::copy(digits, digits + count, shown);
+        shown_count = count;
+        lv_obj_invalidate(obj);
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (digits[i] == shown[i]) continue;
+        shown[i] = digits[i];
+        lv_area_t area;
+        cellArea(i, area);
+        lv_obj_invalidate_area(obj, &area);
+    }
+}
+
+void SpeedWidget::drawEvent(lv_event_t* e) {
+    SpeedWidget* self = (SpeedWidget*)lv_event_get_user_data(e);
+    lv_layer_t* layer = lv_event_get_layer(e);
+
+    lv_draw_image_dsc_t image_dsc;
+    lv_draw_image_dsc_init(&image_dsc);
+    image_dsc.recolor = self->color;
+    image_dsc.recolor_opa = LV_OPA_COVER;
+    image_dsc.opa = lv_obj_get_style_opa_recursive(self->obj, LV_PART_MAIN);
+
+    // Cells outside the invalidated area are dropped by the clip
+    for (int i = 0; i < self->shown_count; i++) {
+        lv_area_t area;
+        self->cellArea(i, area);
+        image_dsc.src = &self->digit_images[self->shown[i]];
+        lv_draw_image(layer, &image_dsc, &area);
+    }
+}
@@ -0,0 +1,136 @@
+#include "StaticLayerCache.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+static bool overlaps(const lv_area_t& a, const lv_area_t& b) {
+    return a.x1 <= b.x2 && b.x1 <= a.x2 && a.y1 <= b.y2 && b.y1 <= a.y2;
+}
+
+void StaticLayerCache::attach(lv_obj_t* target, lv_obj_t* const* named_objects, size_t named_count) {
+    screen = target;
+    named.assign(named_objects, named_objects + named_count);
+
+    candidates.clear();
+    uint32_t count = lv_obj_get_child_count(screen);
+    for (uint32_t i = 0; i < count; i++) {
+        lv_obj_t* child = lv_obj_get_child(screen, i);
+        if (!isNamed(child)) candidates.push_back(child);
+    }
+
+    lv_obj_add_event_cb(screen, screenEvent, LV_EVENT_STYLE_CHANGED, this);
+    lv_obj_add_event_cb(screen, screenEvent, LV_EVENT_SIZE_CHANGED, this);
+    lv_obj_add_event_cb(screen, screenEvent, LV_EVENT_CHILD_CREATED, this);
+    lv_obj_add_event_cb(screen, screenEvent, LV_EVENT_CHILD_DELETED, this);
+}
+
+// An object is dynamic if code holds it or anything inside it
+bool StaticLayerCache::isNamed(lv_obj_t* obj) const {
+    if (std::find(named.begin(), named.end(), obj) != named.end()) return true;
+    uint32_t count = lv_obj_get_child_count(obj);
+    for (uint32_t i = 0; i < count; i++) {
+        if (isNamed(lv_obj_get_child(obj, i))) return true;
+    }
+    return false;
+}
+
+void StaticLayerCache::screenEvent(lv_event_t* e) {
+    StaticLayerCache* self = (StaticLayerCache*)lv_event_get_user_data(e);
+    if (!self->rebuilding) self->invalidate();
+}
+
+void StaticLayerCache::invalidate() {
+    if (pending || !screen) return;
+    pending = true;
+    lv_async_call(rebuildAsync, this);
+}
+
+void StaticLayerCache::rebuildAsync(void* user_data) {
+    StaticLayerCache* self = (StaticLayerCache*)user_data;
+    self->pending = false;
+    self->rebuild();
+}
+
+// Back to drawing every child live
+void StaticLayerCache::restore() {
+    for (lv_obj_t* obj : flattened) {
+        lv_obj_clear_flag(obj, LV_OBJ_FLAG_HIDDEN);
+    }
+    flattened.clear();
+    if (has_snapshot) {
+        lv_obj_set_style_bg_image_src(screen, nullptr, LV_PART_MAIN | LV_STATE_DEFAULT);
+        has_snapshot = false;
+    }
+}
+
+void StaticLayerCache::rebuild() {
+    if (!screen) return;
+    rebuilding = true;
+    restore();
+    lv_obj_update_layout(screen);
+
+    // Current children, bottom to top; deleted candidates simply never match
+    std::vector<lv_obj_t*> children;
+    uint32_t count = lv_obj_get_child_count(screen);
+    for (uint32_t i = 0; i < count; i++) {
+        children.push_back(lv_obj_get_child(screen, i));
+    }
+
+    std::vector<lv_obj_t*> flatten;
+    std::vector<lv_area_t> dynamic_below;
+    for (lv_obj_t* child : children) {
+        lv_area_t coords;
+        lv_obj_get_coords(child, &coords);
+
+        bool candidate = std::find(candidates.begin(), candidates.end(), child) != candidates.end();
+        bool covered = std::any_of(dynamic_below.begin(), dynamic_below.end(),
+                                   [&](const lv_area_t& area) { return overlaps(area, coords); });
+        if (candidate && !covered && !lv_obj_has_flag(child, LV_OBJ_FLAG_HIDDEN) &&
+            !lv_obj_has_flag(child, LV_OBJ_FLAG_CLICKABLE)) {
+            flatten.push_back(child);
+        } else {
+            dynamic_below.push_back(coords);
+        }
+    }
+
+    if (flatten.empty()) {
+        rebuilding = false;
+        return;
+    }
+
+    // Snapshot the screen with only the static children showing
+    std::vector<lv_obj_t*> hidden_for_snapshot;
+    for (lv_obj_t* child : children) {
+        if (std::find(flatten.begin(), flatten.end(), child) != flatten.end()) continue;
+        if (lv_obj_has_flag(child, LV_OBJ_FLAG_HIDDEN)) continue;
+        lv_obj_add_flag(child, LV_OBJ_FLAG_HIDDEN);
+        hidden_for_snapshot.push_back(child);
+    }
+
+    lv_color_format_t cf = lv_display_get_color_format(lv_display_get_default());
+    uint32_t size = lv_snapshot_buf_size_needed(screen, cf);
+    buffer.resize(size);
+    memset(&snapshot, 0, sizeof(snapshot));
+    lv_result_t result = lv_snapshot_take_to_buf(screen, cf, &snapshot, buffer.data(), size);
+
+    for (lv_obj_t* child : hidden_for_snapshot) {
+        lv_obj_clear_flag(child, LV_OBJ_FLAG_HIDDEN);
+    }
+
+    if (result != LV_RESULT_OK) {
+        std::cerr << "StaticLayer: Snapshot failed, drawing everything live" << std::endl;
+        rebuilding = false;
+        return;
+    }
+
+    for (lv_obj_t* child : flatten) {
+        lv_obj_add_flag(child, LV_OBJ_FLAG_HIDDEN);
+    }
+    flattened = flatten;
+    lv_obj_set_style_bg_image_src(screen, &snapshot, LV_PART_MAIN | LV_STATE_DEFAULT);
+    has_snapshot = true;
+    rebuilding = false;
+
+    std::cout << "StaticLayer: " << flattened.size() << " objects flattened into a "
+              << snapshot.header.w << "x" << snapshot.header.h << " background (" << size / 1024 << " KB)" << std::endl;
+}
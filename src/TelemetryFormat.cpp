@@ -0,0 +1,278 @@
+#include "TelemetryFormat.h"
+#include "Crc32.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+// Field layout per record type. Order matters: the most frequently
+// changing fields get the low mask bits so the record header stays one byte.
+//
+// BMS:        current 0.01A, voltage 0.01V, min/max cell 1mV, ESP32 timestamp,
+//             SOC 0.1% with dataValid in bit 0, min/max temperature 0.1C
+// Automotive: speed 0.1km/h, ESP32 timestamp, rpm, bit-packed flags
+// Both end with the receive time (Unix ms).
+enum BmsField {
+    BMS_CURRENT, BMS_VOLTAGE, BMS_MIN_CELL, BMS_MAX_CELL, BMS_TIMESTAMP,
+    BMS_SOC_VALID, BMS_MIN_TEMP, BMS_MAX_TEMP, BMS_RECEIVE_TIME,
+    BMS_FIELD_COUNT
+};
+
+enum AutoField {
+    AUTO_SPEED, AUTO_TIMESTAMP, AUTO_RPM, AUTO_FLAGS, AUTO_RECEIVE_TIME,
+    AUTO_FIELD_COUNT
+};
+
+static const int FIELD_COUNT[2] = {BMS_FIELD_COUNT, AUTO_FIELD_COUNT};
+static const int TIMESTAMP_FIELD[2] = {BMS_TIMESTAMP, AUTO_TIMESTAMP};
+static const int RECEIVE_TIME_FIELD[2] = {BMS_RECEIVE_TIME, AUTO_RECEIVE_TIME};
+
+// Receive time follows the sender clock; only corrections beyond this are
+// stored, so decoded receive times are within +-TIME_TOLERANCE_MS.
+static const int64_t TIME_TOLERANCE_MS = 20;
+
+static int64_t quantize(float value, float scale) {
+    return (int64_t)std::lround(value * scale);
+}
+
+static uint16_t packFlags(const automotive_data_t& data) {
+    return (data.reverse << 0) | (data.forward << 1) | (data.abblendlicht << 2) |
+           (data.vollicht << 3) | (data.nebelHinten << 4) | (data.indicatorLeft << 5) |
+           (data.indicatorRight << 6) | (data.bremsfluid << 7) | (data.handbremse << 8) |
+           (data.lightOn << 9);
+}
+
+static void unpackFlags(uint16_t flags, automotive_data_t& data) {
+    data.reverse = flags & (1 << 0);
+    data.forward = flags & (1 << 1);
+    data.abblendlicht = flags & (1 << 2);
+    data.vollicht = flags & (1 << 3);
+    data.nebelHinten = flags & (1 << 4);
+    data.indicatorLeft = flags & (1 << 5);
+    data.indicatorRight = flags & (1 << 6);
+    data.bremsfluid = flags & (1 << 7);
+    data.handbremse = flags & (1 << 8);
+    data.lightOn = flags & (1 << 9);
+}
+
+static void toFields(const TelemetrySample& sample, int64_t* fields) {
+    if (sample.type == TELEMETRY_BMS) {
+        const bms_data_t& bms = sample.bms;
+        fields[BMS_CURRENT] = quantize(bms.current, 100.0f);
+        fields[BMS_VOLTAGE] = quantize(bms.totalVoltage, 100.0f);
+        fields[BMS_MIN_CELL] = quantize(bms.minVoltage, 1000.0f);
+        fields[BMS_MAX_CELL] = quantize(bms.maxVoltage, 1000.0f);
+        fields[BMS_TIMESTAMP] = bms.timestamp;
+        fields[BMS_SOC_VALID] = quantize(bms.soc, 10.0f) * 2 + (bms.dataValid ? 1 : 0);
+        fields[BMS_MIN_TEMP] = quantize(bms.minTemp, 10.0f);
+        fields[BMS_MAX_TEMP] = quantize(bms.maxTemp, 10.0f);
+        fields[BMS_RECEIVE_TIME] = sample.time_ms;
+    } else {
+        const automotive_data_t& automotive = sample.automotive;
+        fields[AUTO_SPEED] = quantize(automotive.speed_kmh, 10.0f);
+        fields[AUTO_TIMESTAMP] = automotive.timestamp;
+        fields[AUTO_RPM] = automotive.rpm;
+        fields[AUTO_FLAGS] = packFlags(automotive);
+        fields[AUTO_RECEIVE_TIME] = sample.time_ms;
+    }
+}
+
+static void fromFields(const int64_t* fields, TelemetrySample& sample) {
+    if (sample.type == TELEMETRY_BMS) {
+        bms_data_t& bms = sample.bms;
+        bms.current = fields[BMS_CURRENT] / 100.0f;
+        bms.totalVoltage = fields[BMS_VOLTAGE] / 100.0f;
+        bms.minVoltage = fields[BMS_MIN_CELL] / 1000.0f;
+        bms.maxVoltage = fields[BMS_MAX_CELL] / 1000.0f;
+        bms.timestamp = (uint32_t)fields[BMS_TIMESTAMP];
+        bms.soc = (fields[BMS_SOC_VALID] >> 1) / 10.0f;
+        bms.dataValid = fields[BMS_SOC_VALID] & 1;
+        bms.minTemp = fields[BMS_MIN_TEMP] / 10.0f;
+        bms.maxTemp = fields[BMS_MAX_TEMP] / 10.0f;
+    } else {
+        automotive_data_t& automotive = sample.automotive;
+        automotive.speed_kmh = fields[AUTO_SPEED] / 10.0f;
+        automotive.timestamp = (uint32_t)fields[AUTO_TIMESTAMP];
+        automotive.rpm = (uint16_t)fields[AUTO_RPM];
+        unpackFlags((uint16_t)fields[AUTO_FLAGS], automotive);
+    }
+    sample.time_ms = fields[RECEIVE_TIME_FIELD[sample.type]];
+}
+
+// Sender timestamps come at a fixed rate - predict a constant step. Receive
+// time advances with the sender clock. `fields` holds the lower-numbered
+// fields of the current record, already reconstructed.
+static int64_t predict(const TelemetryFieldState& state, int type, int field,
+                       const int64_t* fields, int64_t base_time) {
+    int ts = TIMESTAMP_FIELD[type];
+    if (field == ts) {
+        return state.value[ts] + state.step[ts];
+    }
+    if (field == RECEIVE_TIME_FIELD[type]) {
+        if (!state.seen) return base_time;
+        return state.value[field] + (fields[ts] - state.value[ts]);
+    }
+    return state.value[field];
+}
+
+static void update(TelemetryFieldState& state, int type, const int64_t* fields) {
+    int ts = TIMESTAMP_FIELD[type];
+    state.step[ts] = fields[ts] - state.value[ts];
+    for (int f = 0; f < FIELD_COUNT[type]; f++) {
+        state.value[f] = fields[f];
+    }
+    state.seen = true;
+}
+
+// ---- Varints ----
+
+static void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+static bool getVarint(const uint8_t*& p, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        uint8_t byte = *p++;
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+static uint64_t zigzag(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static int64_t unzigzag(uint64_t value) {
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+// ---- Encoder ----
+
+void TelemetryChunkEncoder::reset() {
+    payload.clear();
+    record_count = 0;
+    first_time_ms = 0;
+    last_time_ms = 0;
+    state[0] = TelemetryFieldState();
+    state[1] = TelemetryFieldState();
+}
+
+void TelemetryChunkEncoder::add(const TelemetrySample& sample) {
+    int type = sample.type;
+    int64_t fields[TelemetryFieldState::MAX_FIELDS];
+    toFields(sample, fields);
+
+    if (record_count == 0) {
+        first_time_ms = last_time_ms = sample.time_ms;
+    }
+
+    uint32_t mask = 0;
+    int64_t deltas[TelemetryFieldState::MAX_FIELDS];
+    for (int f = 0; f < FIELD_COUNT[type]; f++) {
+        int64_t predicted = predict(state[type], type, f, fields, first_time_ms);
+        deltas[f] = fields[f] - predicted;
+        if (f == RECEIVE_TIME_FIELD[type] && std::llabs(deltas[f]) <= TIME_TOLERANCE_MS) {
+            // Close enough - keep the decoder's view so both sides stay in sync
+            deltas[f] = 0;
+            fields[f] = predicted;
+        }
+        if (deltas[f] != 0) mask |= 1u << f;
+    }
+
+    putVarint(payload, ((uint64_t)mask << 1) | type);
+    for (int f = 0; f < FIELD_COUNT[type]; f++) {
+        if (mask & (1u << f)) putVarint(payload, zigzag(deltas[f]));
+    }
+
+    update(state[type], type, fields);
+    last_time_ms = std::max(last_time_ms, fields[RECEIVE_TIME_FIELD[type]]);
+    record_count++;
+}
+
+void TelemetryChunkEncoder::finish(std::vector<uint8_t>& out) const {
+    TelemetryChunkHeader header;
+    header.magic = TELEMETRY_CHUNK_MAGIC;
+    header.payload_size = payload.size();
+    header.record_count = record_count;
+    header.payload_crc = crc32(payload.data(), payload.size());
+    header.first_time_ms = first_time_ms;
+    header.last_time_ms = last_time_ms;
+
+    out.resize(sizeof(header) + payload.size());
+    memcpy(out.data(), &header, sizeof(header));
+    memcpy(out.data() + sizeof(header), payload.data(), payload.size());
+}
+
+// ---- Reader ----
+
+bool TelemetryReader::verifyChunk(const TelemetryChunkHeader& header, const uint8_t* payload) {
+    return crc32(payload, header.payload_size) == header.payload_crc;
+}
+
+bool TelemetryReader::forEachChunk(const uint8_t* data, size_t size, const ChunkCallback& callback,
+                                   bool verify_crc) {
+    TelemetryFileHeader file_header;
+    if (size < sizeof(file_header)) return false;
+    memcpy(&file_header, data, sizeof(file_header));
+    if (file_header.magic != TELEMETRY_FILE_MAGIC || file_header.version != TELEMETRY_VERSION ||
+        file_header.header_size < sizeof(file_header) || file_header.header_size > size) {
+        return false;
+    }
+
+    size_t offset = file_header.header_size;
+    while (offset + sizeof(TelemetryChunkHeader) <= size) {
+        TelemetryChunkHeader header;
+        memcpy(&header, data + offset, sizeof(header));
+        if (header.magic != TELEMETRY_CHUNK_MAGIC ||
+            header.payload_size > size - offset - sizeof(header)) {
+            break;  // Torn tail from a power cut
+        }
+
+        const uint8_t* payload = data + offset + sizeof(header);
+        if (verify_crc && !verifyChunk(header, payload)) break;
+
+        if (!callback(header, payload, offset)) break;
+        offset += sizeof(header) + header.payload_size;
+    }
+    return true;
+}
+
+bool TelemetryReader::decodeChunk(const TelemetryChunkHeader& header, const uint8_t* payload,
+                                  const SampleCallback& callback) {
+    const uint8_t* p = payload;
+    const uint8_t* end = payload + header.payload_size;
+
+    TelemetryFieldState state[2];
+    TelemetrySample sample;
+
+    for (uint32_t r = 0; r < header.record_count; r++) {
+        uint64_t tag;
+        if (!getVarint(p, end, tag)) return false;
+
+        int type = tag & 1;
+        uint32_t mask = (uint32_t)(tag >> 1);
+        if (mask >> FIELD_COUNT[type]) return false;
+
+        int64_t fields[TelemetryFieldState::MAX_FIELDS];
+        for (int f = 0; f < FIELD_COUNT[type]; f++) {
+            fields[f] = predict(state[type], type, f, fields, header.first_time_ms);
+            if (mask & (1u << f)) {
+                uint64_t delta;
+                if (!getVarint(p, end, delta)) return false;
+                fields[f] += unzigzag(delta);
+            }
+        }
+        update(state[type], type, fields);
+
+        sample.type = (TelemetryType)type;
+        fromFields(fields, sample);
+        callback(sample);
+    }
+    return p == end;
+}
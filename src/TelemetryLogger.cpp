@@ -0,0 +1,265 @@
+#include "TelemetryLogger.h"
+#include "DataPaths.h"
+#include "Trace.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+static const std::chrono::milliseconds WORKER_WAKE_INTERVAL(250);
+
+static int64_t unixTimeMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static bool writeAll(int fd, const void* data, size_t size) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        ssize_t n = write(fd, p, size);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+TelemetryLogger::TelemetryLogger(TelemetryLoggerConfig config) : config(config) {
+    if (this->config.directory.empty()) {
+        this->config.directory = dataDirectory() + "/telemetry";
+    }
+}
+
+TelemetryLogger::~TelemetryLogger() {
+    stop();
+}
+
+bool TelemetryLogger::start() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (running) return true;
+
+    if (!makeDirectories(config.directory)) {
+        std::cerr << "Telemetry: Cannot create " << config.directory << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    queue.reserve(1024);
+    running = true;
+    worker_thread = std::thread(&TelemetryLogger::workerLoop, this);
+    std::cout << "Telemetry: Logging to " << config.directory << std::endl;
+    return true;
+}
+
+void TelemetryLogger::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) return;
+        running = false;
+    }
+    wake.notify_one();
+
+    // workerLoop() writes the open chunk before it returns
+    if (worker_thread.joinable()) {
+        worker_thread.join();
+    }
+    closeFile();
+
+    uint64_t written = getWrittenBytes();
+    std::cout << "Telemetry: Stopped - " << getRecords() << " records, " << written << " bytes";
+    if (written > 0) {
+        std::cout << " (" << (double)getRawBytes() / written << "x)";
+    }
+    std::cout << std::endl;
+}
+
+void TelemetryLogger::logBMS(const bms_data_t& data) {
+    TelemetrySample sample;
+    sample.type = TELEMETRY_BMS;
+    sample.time_ms = unixTimeMs();
+    sample.bms = data;
+    push(sample);
+    raw_bytes.fetch_add(sizeof(data), std::memory_order_relaxed);
+}
+
+void TelemetryLogger::logAutomotive(const automotive_data_t& data) {
+    TelemetrySample sample;
+    sample.type = TELEMETRY_AUTOMOTIVE;
+    sample.time_ms = unixTimeMs();
+    sample.automotive = data;
+    push(sample);
+    raw_bytes.fetch_add(sizeof(data), std::memory_order_relaxed);
+}
+
+void TelemetryLogger::push(const TelemetrySample& sample) {
+    // No notify - the worker polls, which keeps this path to one short lock
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!running || queue.size() >= config.max_queued) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    queue.push_back(sample);
+}
+
+void TelemetryLogger::workerLoop() {
+#ifdef ENABLE_TRACING
+    Trace::setThreadName("telemetry");
+#endif
+
+    std::vector<TelemetrySample> batch;
+    batch.reserve(1024);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait_for(lock, WORKER_WAKE_INTERVAL, [this] { return !running; });
+        batch.swap(queue);
+        bool stopping = !running;
+        lock.unlock();
+
+        {
+            TRACE_SCOPE("telemetry_encode");
+            for (const TelemetrySample& sample : batch) {
+                if (encoder.isEmpty()) {
+                    chunk_started = std::chrono::steady_clock::now();
+                }
+                encoder.add(sample);
+                records.fetch_add(1, std::memory_order_relaxed);
+
+                if (encoder.getPayloadSize() >= config.chunk_bytes) {
+                    writeChunk();
+                }
+            }
+            batch.clear();
+        }
+
+        // Bound what a power cut can lose
+        if (!encoder.isEmpty() &&
+            (stopping || std::chrono::steady_clock::now() - chunk_started >= config.chunk_interval)) {
+            writeChunk();
+        }
+
+        lock.lock();
+        if (stopping) break;
+    }
+}
+
+void TelemetryLogger::writeChunk() {
+    TRACE_SCOPE("telemetry_write");
+
+    if (log_fd < 0 || file_bytes >= config.max_file_bytes) {
+        closeFile();
+        if (!openNextFile()) {
+            dropped.fetch_add(encoder.getRecordCount(), std::memory_order_relaxed);
+            encoder.reset();
+            return;
+        }
+        pruneOldFiles();
+    }
+
+    encoder.finish(chunk_buffer);
+
+    TelemetryIndexEntry entry;
+    memcpy(&entry.first_time_ms, chunk_buffer.data() + offsetof(TelemetryChunkHeader, first_time_ms), sizeof(int64_t));
+    memcpy(&entry.last_time_ms, chunk_buffer.data() + offsetof(TelemetryChunkHeader, last_time_ms), sizeof(int64_t));
+    entry.offset = file_bytes;
+
+    if (!writeAll(log_fd, chunk_buffer.data(), chunk_buffer.size())) {
+        std::cerr << "Telemetry: Write failed: " << strerror(errno) << std::endl;
+        dropped.fetch_add(encoder.getRecordCount(), std::memory_order_relaxed);
+        encoder.reset();
+        closeFile();  // Reopen a fresh file next time
+        return;
+    }
+    if (index_fd >= 0) {
+        writeAll(index_fd, &entry, sizeof(entry));
+    }
+
+    file_bytes += chunk_buffer.size();
+    written_bytes.fetch_add(chunk_buffer.size() + sizeof(entry), std::memory_order_relaxed);
+    encoder.reset();
+}
+
+bool TelemetryLogger::openNextFile() {
+    // UTC timestamps sort chronologically by name
+    char stamp[32];
+    time_t now = time(nullptr);
+    struct tm utc;
+    gmtime_r(&now, &utc);
+    strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", &utc);
+
+    std::string path;
+    for (int n = 0; n < 100; n++) {
+        path = config.directory + "/telemetry_" + stamp + (n ? "_" + std::to_string(n) : "") + ".tzl";
+        log_fd = open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        if (log_fd >= 0 || errno != EEXIST) break;
+    }
+    if (log_fd < 0) {
+        std::cerr << "Telemetry: Cannot create log: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    TelemetryFileHeader header = {};
+    header.magic = TELEMETRY_FILE_MAGIC;
+    header.version = TELEMETRY_VERSION;
+    header.header_size = sizeof(header);
+    header.created_ms = unixTimeMs();
+    if (!writeAll(log_fd, &header, sizeof(header))) {
+        closeFile();
+        return false;
+    }
+    file_bytes = sizeof(header);
+    written_bytes.fetch_add(sizeof(header), std::memory_order_relaxed);
+
+    // The index is an accelerator only - tools rebuild it from chunk headers
+    std::string index_path = path + ".idx";
+    index_fd = open(index_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+    std::cout << "Telemetry: Opened " << path << std::endl;
+    return true;
+}
+
+void TelemetryLogger::closeFile() {
+    if (log_fd >= 0) {
+        fdatasync(log_fd);
+        close(log_fd);
+        log_fd = -1;
+    }
+    if (index_fd >= 0) {
+        close(index_fd);
+        index_fd = -1;
+    }
+    file_bytes = 0;
+}
+
+void TelemetryLogger::pruneOldFiles() {
+    DIR* dir = opendir(config.directory.c_str());
+    if (!dir) return;
+
+    std::vector<std::string> logs;
+    while (struct dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name.compare(0, 10, "telemetry_") == 0 && name.size() > 4 &&
+            name.compare(name.size() - 4, 4, ".tzl") == 0) {
+            logs.push_back(name);
+        }
+    }
+    closedir(dir);
+
+    if ((int)logs.size() <= config.max_files) return;
+
+    std::sort(logs.begin(), logs.end());
+    size_t excess = logs.size() - config.max_files;
+    for (size_t i = 0; i < excess; i++) {
+        std::string path = config.directory + "/" + logs[i];
+        unlink(path.c_str());
+        unlink((path + ".idx").c_str());
+        std::cout << "Telemetry: Rotated out " << logs[i] << std::endl;
+    }
+}
@@ -0,0 +1,77 @@
+#include "TimeSeriesPyramid.h"
+#include <algorithm>
+
+const uint32_t TimeSeriesPyramid::LEVEL_MS[LEVELS] = {1000, 10000, 60000, 600000};
+const size_t TimeSeriesPyramid::LEVEL_CAPACITY[LEVELS] = {600, 360, 240, 144};
+
+TimeSeriesPyramid::TimeSeriesPyramid() {
+    for (auto& channel : rings) {
+        for (size_t level = 0; level < LEVELS; level++) {
+            channel[level].buckets.resize(LEVEL_CAPACITY[level]);
+        }
+    }
+}
+
+void TimeSeriesPyramid::add(HistoryChannel channel, float value, uint64_t time_ms) {
+    if (channel >= HISTORY_CHANNELS) return;
+
+    for (size_t level = 0; level < LEVELS; level++) {
+        Ring& ring = rings[channel][level];
+        int64_t index = bucketIndex(level, time_ms);
+
+        HistoryBucket* bucket = ring.used ? &ring.buckets[ring.newest] : nullptr;
+        if (!bucket || bucket->index != index) {
+            // Open the next bucket, overwriting the oldest once full
+            if (ring.used) {
+                ring.newest = (ring.newest + 1) % ring.buckets.size();
+            }
+            ring.used = std::min(ring.used + 1, ring.buckets.size());
+            bucket = &ring.buckets[ring.newest];
+            bucket->index = index;
+            bucket->min = bucket->max = value;
+            bucket->sum = 0.0f;
+            bucket->count = 0;
+        }
+
+        bucket->min = std::min(bucket->min, value);
+        bucket->max = std::max(bucket->max, value);
+        bucket->sum += value;
+        bucket->count++;
+    }
+}
+
+size_t TimeSeriesPyramid::levelFor(uint64_t window_ms, size_t max_points) const {
+    for (size_t level = 0; level < LEVELS; level++) {
+        uint64_t points = (window_ms + LEVEL_MS[level] - 1) / LEVEL_MS[level];
+        if (points <= max_points && points <= LEVEL_CAPACITY[level]) {
+            return level;
+        }
+    }
+    return LEVELS - 1;
+}
+
+void TimeSeriesPyramid::read(HistoryChannel channel, size_t level, uint64_t now_ms, size_t points, HistoryBucket* out) const {
+    if (channel >= HISTORY_CHANNELS || level >= LEVELS) return;
+
+    const Ring& ring = rings[channel][level];
+    int64_t newest_index = bucketIndex(level, now_ms);
+
+    // Walk the ring backwards alongside the output, newest first
+    size_t remaining = ring.used;
+    size_t position = ring.newest;
+    for (size_t i = 0; i < points; i++) {
+        int64_t target = newest_index - (int64_t)i;
+        HistoryBucket& slot = out[points - 1 - i];
+
+        while (remaining && ring.buckets[position].index > target) {
+            position = (position + ring.buckets.size() - 1) % ring.buckets.size();
+            remaining--;
+        }
+        if (remaining && ring.buckets[position].index == target) {
+            slot = ring.buckets[position];
+        } else {
+            slot = HistoryBucket();
+            slot.index = target;
+        }
+    }
+}
@@ -0,0 +1,193 @@
+#include "Trace.h"
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <csignal>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+namespace {
+
+// Per-thread ring buffer. Single writer (the owning thread); the dump reads
+// it without stopping the writer, so the oldest entries may be in the middle
+// of being overwritten - those are skipped (see snapshot()).
+struct ThreadTraceBuffer {
+    static constexpr size_t CAPACITY = 16384;      // Power of two
+    static constexpr size_t OVERWRITE_MARGIN = 64; // Entries skipped when wrapped
+
+    TraceEvent events[CAPACITY];
+    std::atomic<uint64_t> head{0};
+    long tid = 0;
+    std::atomic<const char*> thread_name{nullptr};
+
+    void push(const TraceEvent& event) {
+        uint64_t index = head.load(std::memory_order_relaxed);
+        events[index & (CAPACITY - 1)] = event;
+        head.store(index + 1, std::memory_order_release);
+    }
+
+    std::vector<TraceEvent> snapshot() const {
+        uint64_t end = head.load(std::memory_order_acquire);
+        uint64_t begin = 0;
+        if (end > CAPACITY) {
+            begin = end - CAPACITY + OVERWRITE_MARGIN;
+        }
+
+        std::vector<TraceEvent> out;
+        out.reserve(end - begin);
+        for (uint64_t i = begin; i < end; i++) {
+            out.push_back(events[i & (CAPACITY - 1)]);
+        }
+        return out;
+    }
+};
+
+// Buffers are never freed so a dump still sees threads that already exited
+std::mutex registry_mutex;
+std::vector<ThreadTraceBuffer*> registry;
+
+const auto trace_epoch = std::chrono::steady_clock::now();
+volatile sig_atomic_t dump_requested = 0;
+
+// Name given before the thread's first event; applied when the buffer is created
+thread_local const char* pending_thread_name = nullptr;
+thread_local ThreadTraceBuffer* thread_buffer = nullptr;
+
+ThreadTraceBuffer* threadBuffer() {
+    ThreadTraceBuffer*& buffer = thread_buffer;
+    if (!buffer) {
+        buffer = new ThreadTraceBuffer();
+        buffer->tid = syscall(SYS_gettid);
+        buffer->thread_name.store(pending_thread_name, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        registry.push_back(buffer);
+    }
+    return buffer;
+}
+
+void onDumpSignal(int) {
+    dump_requested = 1;
+}
+
+void writeJsonString(std::ostream& out, const char* text) {
+    out << '"';
+    for (const char* p = text; *p; p++) {
+        if (*p == '"' || *p == '\\') out << '\\';
+        out << *p;
+    }
+    out << '"';
+}
+
+} // namespace
+
+std::atomic<bool> Trace::enabled{false};
+
+void Trace::setEnabled(bool on) {
+    enabled.store(on, std::memory_order_relaxed);
+    std::cout << "Trace: Recording " << (on ? "enabled" : "disabled") << std::endl;
+}
+
+void Trace::initFromEnvironment() {
+    const char* env = std::getenv("TAZZARI_TRACE");
+    if (env && env[0] == '1') {
+        setEnabled(true);
+    }
+}
+
+void Trace::setThreadName(const char* name) {
+    // The ring is only allocated once the thread records, so naming a thread
+    // costs nothing while tracing is off
+    pending_thread_name = name;
+    if (thread_buffer) {
+        thread_buffer->thread_name.store(name, std::memory_order_relaxed);
+    }
+}
+
+uint64_t Trace::nowUs() {
+    auto elapsed = std::chrono::steady_clock::now() - trace_epoch;
+    // +1 keeps 0 free as the "not recording" marker used by TraceScope
+    return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() + 1;
+}
+
+void Trace::record(const char* name, char phase, uint64_t ts_us, uint64_t dur_us) {
+    threadBuffer()->push(TraceEvent{name, ts_us, dur_us, phase});
+}
+
+void Trace::complete(const char* name, uint64_t start_us) {
+    uint64_t now = nowUs();
+    record(name, 'X', start_us, now - start_us);
+}
+
+void Trace::begin(const char* name) {
+    record(name, 'B', nowUs(), 0);
+}
+
+void Trace::end(const char* name) {
+    record(name, 'E', nowUs(), 0);
+}
+
+void Trace::installDumpSignal(int signal_number) {
+    struct sigaction action = {};
+    action.sa_handler = onDumpSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(signal_number, &action, nullptr);
+}
+
+bool Trace::takeDumpRequest() {
+    if (!dump_requested) return false;
+    dump_requested = 0;
+    return true;
+}
+
+bool Trace::dumpChromeJson(const std::string& path) {
+    std::vector<ThreadTraceBuffer*> buffers;
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        buffers = registry;
+    }
+
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "Trace: Cannot write " << path << std::endl;
+        return false;
+    }
+
+    long pid = getpid();
+    size_t event_count = 0;
+    bool first = true;
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    for (const ThreadTraceBuffer* buffer : buffers) {
+        const char* thread_name = buffer->thread_name.load(std::memory_order_relaxed);
+        if (thread_name) {
+            out << (first ? "" : ",\n")
+                << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+                << ",\"tid\":" << buffer->tid << ",\"args\":{\"name\":";
+            writeJsonString(out, thread_name);
+            out << "}}";
+            first = false;
+        }
+
+        for (const TraceEvent& event : buffer->snapshot()) {
+            out << (first ? "" : ",\n") << "{\"name\":";
+            writeJsonString(out, event.name);
+            out << ",\"ph\":\"" << event.phase << "\",\"ts\":" << event.ts_us;
+            if (event.phase == 'X') {
+                out << ",\"dur\":" << event.dur_us;
+            }
+            out << ",\"pid\":" << pid << ",\"tid\":" << buffer->tid << "}";
+            first = false;
+            event_count++;
+        }
+    }
+    out << "\n]}\n";
+    out.close();
+
+    std::cout << "Trace: Wrote " << event_count << " events from " << buffers.size()
+              << " threads to " << path << std::endl;
+    return true;
+}
@@ -0,0 +1,373 @@
+#include "TripHistory.h"
+#include "DataPaths.h"
+#include "Trace.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define TRIP_FILE_MAGIC     0x52545A54u  // "TZTR"
+#define TRIP_BLOCK_MAGIC    0x42545A54u  // "TZTB"
+#define TRIP_FILE_VERSION   1
+
+// File header, padded to FILE_HEADER_SIZE
+struct TripFileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t column_count;
+    uint32_t block_capacity;
+};
+
+// Block header, padded to BLOCK_HEADER_SIZE; count is written last on append
+struct TripBlockHeader {
+    uint32_t count;
+    uint32_t magic;
+};
+
+static const size_t FILE_HEADER_SIZE = 64;
+static const size_t BLOCK_HEADER_SIZE = 16;
+
+// ---- TripAccumulator ----
+
+void TripAccumulator::start(int64_t now) {
+    record = TripRecord();
+    record.start_time = now;
+    distance_km = 0.0;
+    moving_hours = 0.0;
+    used_wh = 0.0;
+    regen_wh = 0.0;
+    battery_seen = false;
+    active = true;
+}
+
+void TripAccumulator::addDistance(double km, double hours) {
+    distance_km += km;
+    moving_hours += hours;
+}
+
+void TripAccumulator::addSpeed(float speed_kmh) {
+    record.speed_max_kmh = std::max(record.speed_max_kmh, speed_kmh);
+}
+
+void TripAccumulator::addEnergy(double used, double regen) {
+    used_wh += used;
+    regen_wh += regen;
+}
+
+void TripAccumulator::addBattery(float soc, float temp_min, float temp_max) {
+    if (!battery_seen) {
+        record.soc_min = record.soc_max = soc;
+        record.temp_min_c = temp_min;
+        record.temp_max_c = temp_max;
+        battery_seen = true;
+        return;
+    }
+    record.soc_min = std::min(record.soc_min, soc);
+    record.soc_max = std::max(record.soc_max, soc);
+    record.temp_min_c = std::min(record.temp_min_c, temp_min);
+    record.temp_max_c = std::max(record.temp_max_c, temp_max);
+}
+
+bool TripAccumulator::close(int64_t now, TripRecord& out) {
+    if (!active) return false;
+    active = false;
+
+    // Ignition cycles without movement are not trips
+    if (distance_km < 0.01) return false;
+
+    record.end_time = now;
+    record.distance_km = distance_km;
+    record.energy_used_wh = used_wh;
+    record.energy_regen_wh = regen_wh;
+    record.speed_avg_kmh = moving_hours > 0.0 ? distance_km / moving_hours : 0.0;
+    out = record;
+    return true;
+}
+
+// ---- TripHistory ----
+
+TripHistory::TripHistory(const std::string& path) : path(path) {
+}
+
+TripHistory::~TripHistory() {
+    close();
+}
+
+std::string TripHistory::defaultPath() {
+    return dataDirectory() + "/trips.col";
+}
+
+size_t TripHistory::columnWidth(int column) {
+    return column <= COL_END_TIME ? sizeof(int64_t) : sizeof(float);
+}
+
+size_t TripHistory::columnOffset(int column) {
+    size_t offset = BLOCK_HEADER_SIZE;
+    for (int c = 0; c < column; c++) {
+        offset += columnWidth(c) * BLOCK_CAPACITY;
+    }
+    return offset;
+}
+
+size_t TripHistory::blockSize() {
+    return columnOffset(COLUMN_COUNT);
+}
+
+size_t TripHistory::blockOffset(size_t block) {
+    return FILE_HEADER_SIZE + block * blockSize();
+}
+
+bool TripHistory::open() {
+    makeDirectories(directoryOf(path));
+
+    write_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (write_fd < 0) {
+        std::cerr << "Trips: Cannot open " << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct stat st;
+    fstat(write_fd, &st);
+
+    TripFileHeader header = {};
+    if (st.st_size < (off_t)FILE_HEADER_SIZE) {
+        // New database
+        uint8_t header_data[FILE_HEADER_SIZE] = {0};
+        header.magic = TRIP_FILE_MAGIC;
+        header.version = TRIP_FILE_VERSION;
+        header.column_count = COLUMN_COUNT;
+        header.block_capacity = BLOCK_CAPACITY;
+        memcpy(header_data, &header, sizeof(header));
+        if (pwrite(write_fd, header_data, FILE_HEADER_SIZE, 0) != (ssize_t)FILE_HEADER_SIZE) {
+            close();
+            return false;
+        }
+        fdatasync(write_fd);
+        write_blocks = 0;
+    } else {
+        if (pread(write_fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+            header.magic != TRIP_FILE_MAGIC || header.version != TRIP_FILE_VERSION ||
+            header.column_count != COLUMN_COUNT || header.block_capacity != BLOCK_CAPACITY) {
+            std::cerr << "Trips: " << path << " has an unknown layout - not touching it" << std::endl;
+            close();
+            return false;
+        }
+        // A block is only counted once it was fully preallocated
+        write_blocks = (st.st_size - FILE_HEADER_SIZE) / blockSize();
+    }
+
+    write_tail_count = 0;
+    if (write_blocks > 0 && !recoverTailBlock()) {
+        close();
+        return false;
+    }
+
+    read_fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    size_t trips = getTripCount();
+    std::cout << "Trips: " << trips << " trips in " << path << std::endl;
+    return true;
+}
+
+void TripHistory::close() {
+    if (map_base) {
+        munmap((void*)map_base, map_size);
+        map_base = nullptr;
+        map_size = 0;
+    }
+    if (read_fd >= 0) {
+        ::close(read_fd);
+        read_fd = -1;
+    }
+    if (write_fd >= 0) {
+        ::close(write_fd);
+        write_fd = -1;
+    }
+}
+
+bool TripHistory::recoverTailBlock() {
+    off_t offset = blockOffset(write_blocks - 1);
+    TripBlockHeader block = {};
+    if (pread(write_fd, &block, sizeof(block), offset) != (ssize_t)sizeof(block)) {
+        std::cerr << "Trips: Cannot read " << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    if (block.magic != TRIP_BLOCK_MAGIC) {
+        // Torn between preallocating the block and writing its header.
+        // Readers skip a block without magic, so restore it before anything
+        // is appended; a count that made it to disk only follows durable values.
+        block.magic = TRIP_BLOCK_MAGIC;
+        block.count = std::min(block.count, BLOCK_CAPACITY);
+        if (pwrite(write_fd, &block, sizeof(block), offset) != (ssize_t)sizeof(block) ||
+            fdatasync(write_fd) != 0) {
+            std::cerr << "Trips: Cannot repair block " << write_blocks - 1 << ": " << strerror(errno) << std::endl;
+            return false;
+        }
+        std::cout << "Trips: Repaired header of block " << write_blocks - 1 << std::endl;
+    }
+
+    write_tail_count = std::min(block.count, BLOCK_CAPACITY);
+    return true;
+}
+
+bool TripHistory::append(const TripRecord& trip) {
+    if (write_fd < 0) return false;
+    TRACE_SCOPE("trip_append");
+
+    // Start a new block when the last one is full (or there is none)
+    if (write_blocks == 0 || write_tail_count >= BLOCK_CAPACITY) {
+        off_t offset = blockOffset(write_blocks);
+        int err = posix_fallocate(write_fd, offset, blockSize());
+        if (err != 0) {
+            std::cerr << "Trips: Cannot grow " << path << ": " << strerror(err) << std::endl;
+            return false;
+        }
+        TripBlockHeader block = {0, TRIP_BLOCK_MAGIC};
+        if (pwrite(write_fd, &block, sizeof(block), offset) != (ssize_t)sizeof(block)) {
+            // open() restores the header of a preallocated tail block
+            std::cerr << "Trips: Block header write failed: " << strerror(errno) << std::endl;
+            return false;
+        }
+        write_blocks++;
+        write_tail_count = 0;
+    }
+
+    off_t block_offset = blockOffset(write_blocks - 1);
+    uint32_t index = write_tail_count;
+
+    const void* values[COLUMN_COUNT] = {
+        &trip.start_time, &trip.end_time,
+        &trip.distance_km, &trip.energy_used_wh, &trip.energy_regen_wh,
+        &trip.soc_min, &trip.soc_max, &trip.speed_avg_kmh, &trip.speed_max_kmh,
+        &trip.temp_min_c, &trip.temp_max_c,
+    };
+    for (int column = 0; column < COLUMN_COUNT; column++) {
+        size_t width = columnWidth(column);
+        off_t offset = block_offset + columnOffset(column) + index * width;
+        if (pwrite(write_fd, values[column], width, offset) != (ssize_t)width) {
+            std::cerr << "Trips: Write failed: " << strerror(errno) << std::endl;
+            return false;
+        }
+    }
+
+    // Values durable before the count that makes them visible
+    if (fdatasync(write_fd) != 0) {
+        std::cerr << "Trips: fdatasync failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+    uint32_t new_count = index + 1;
+    if (pwrite(write_fd, &new_count, sizeof(new_count), block_offset) != (ssize_t)sizeof(new_count) ||
+        fdatasync(write_fd) != 0) {
+        std::cerr << "Trips: Commit failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    write_tail_count = new_count;
+    std::cout << "Trips: Recorded " << trip.distance_km << "km, " << trip.energy_used_wh << "Wh used" << std::endl;
+    return true;
+}
+
+bool TripHistory::refreshMapping() {
+    if (read_fd < 0) return false;
+
+    struct stat st;
+    if (fstat(read_fd, &st) != 0) return false;
+    if ((size_t)st.st_size == map_size && map_base) return true;
+
+    if (map_base) {
+        munmap((void*)map_base, map_size);
+        map_base = nullptr;
+        map_size = 0;
+    }
+    if ((size_t)st.st_size < FILE_HEADER_SIZE) return false;
+
+    void* mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, read_fd, 0);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Trips: mmap failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+    map_base = (const uint8_t*)mapped;
+    map_size = st.st_size;
+    return true;
+}
+
+uint32_t TripHistory::blockCount(const uint8_t* base, size_t block) const {
+    TripBlockHeader header;
+    memcpy(&header, base + blockOffset(block), sizeof(header));
+    if (header.magic != TRIP_BLOCK_MAGIC) return 0;
+    return std::min(header.count, BLOCK_CAPACITY);
+}
+
+size_t TripHistory::getTripCount() {
+    if (!refreshMapping()) return 0;
+
+    size_t blocks = (map_size - FILE_HEADER_SIZE) / blockSize();
+    size_t total = 0;
+    for (size_t b = 0; b < blocks; b++) {
+        total += blockCount(map_base, b);
+    }
+    return total;
+}
+
+bool TripHistory::getTrip(size_t index, TripRecord& out) {
+    if (!refreshMapping()) return false;
+
+    size_t blocks = (map_size - FILE_HEADER_SIZE) / blockSize();
+    size_t block = index / BLOCK_CAPACITY;
+    size_t slot = index % BLOCK_CAPACITY;
+    if (block >= blocks || slot >= blockCount(map_base, block)) return false;
+
+    const uint8_t* base = map_base + blockOffset(block);
+    void* values[COLUMN_COUNT] = {
+        &out.start_time, &out.end_time,
+        &out.distance_km, &out.energy_used_wh, &out.energy_regen_wh,
+        &out.soc_min, &out.soc_max, &out.speed_avg_kmh, &out.speed_max_kmh,
+        &out.temp_min_c, &out.temp_max_c,
+    };
+    for (int column = 0; column < COLUMN_COUNT; column++) {
+        size_t width = columnWidth(column);
+        memcpy(values[column], base + columnOffset(column) + slot * width, width);
+    }
+    return true;
+}
+
+TripSummary TripHistory::aggregate(int64_t from_time, int64_t to_time) {
+    TRACE_SCOPE("trip_aggregate");
+    TripSummary summary;
+    if (!refreshMapping()) return summary;
+
+    size_t blocks = (map_size - FILE_HEADER_SIZE) / blockSize();
+    for (size_t b = 0; b < blocks; b++) {
+        uint32_t count = blockCount(map_base, b);
+        const uint8_t* base = map_base + blockOffset(b);
+
+        // Columns are naturally aligned inside the mapping
+        const int64_t* start = (const int64_t*)(base + columnOffset(COL_START_TIME));
+        const int64_t* end = (const int64_t*)(base + columnOffset(COL_END_TIME));
+        const float* distance = (const float*)(base + columnOffset(COL_DISTANCE));
+        const float* used = (const float*)(base + columnOffset(COL_ENERGY_USED));
+        const float* regen = (const float*)(base + columnOffset(COL_ENERGY_REGEN));
+        const float* speed_avg = (const float*)(base + columnOffset(COL_SPEED_AVG));
+        const float* speed_max = (const float*)(base + columnOffset(COL_SPEED_MAX));
+        const float* temp_max = (const float*)(base + columnOffset(COL_TEMP_MAX));
+
+        for (uint32_t i = 0; i < count; i++) {
+            if (start[i] < from_time || end[i] > to_time) continue;
+
+            summary.trips++;
+            summary.distance_km += distance[i];
+            summary.energy_used_wh += used[i];
+            summary.energy_regen_wh += regen[i];
+            if (speed_avg[i] > 0.0f) {
+                summary.driving_hours += distance[i] / speed_avg[i];
+            }
+            summary.speed_max_kmh = std::max(summary.speed_max_kmh, speed_max[i]);
+            summary.temp_max_c = std::max(summary.temp_max_c, temp_max[i]);
+        }
+    }
+    return summary;
+}
@@ -0,0 +1,81 @@
+#include "TripScreen.h"
+#include <cstdio>
+#include <ctime>
+#include <string>
+
+TripScreen::TripScreen(TripHistory& history) : history(history) {
+}
+
+lv_obj_t* TripScreen::build() {
+    lv_obj_t* screen = createScreen("Trips");
+    lbl_totals = createLabel(screen, &lv_font_montserrat_18, 20, 60);
+    lbl_recent = createLabel(screen, &lv_font_montserrat_16, 20, 230);
+    shown_trips = SIZE_MAX;
+    shown_day = -1;
+    return screen;
+}
+
+void TripScreen::release() {
+    lbl_totals = nullptr;
+    lbl_recent = nullptr;
+}
+
+void TripScreen::tick(uint64_t now_ms) {
+    (void)now_ms;
+    time_t now = time(nullptr);
+    struct tm local;
+    localtime_r(&now, &local);
+    int64_t day = local.tm_year * 400 + local.tm_yday;
+
+    size_t trips = history.getTripCount();
+    if (trips == shown_trips && day == shown_day) return;
+    shown_trips = trips;
+    shown_day = day;
+    refresh();
+}
+
+static void appendSummary(std::string& text, const char* name, const TripSummary& summary) {
+    char line[128];
+    snprintf(line, sizeof(line), "%-10s %3zu trips  %7.1f km  %5.1f kWh  %4.0f Wh/km  %5.1f h\n",
+             name, summary.trips, summary.distance_km,
+             (summary.energy_used_wh - summary.energy_regen_wh) / 1000.0, summary.whPerKm(), summary.driving_hours);
+    text += line;
+}
+
+void TripScreen::refresh() {
+    time_t now = time(nullptr);
+    struct tm midnight;
+    localtime_r(&now, &midnight);
+    midnight.tm_hour = midnight.tm_min = midnight.tm_sec = 0;
+    int64_t today = mktime(&midnight);
+
+    std::string text;
+    appendSummary(text, "Today", history.aggregate(today, INT64_MAX));
+    appendSummary(text, "7 days", history.aggregate(now - 7 * 86400, INT64_MAX));
+    appendSummary(text, "30 days", history.aggregate(now - 30 * 86400, INT64_MAX));
+    appendSummary(text, "All", history.aggregate(0, INT64_MAX));
+    setLabelText(lbl_totals, text.c_str());
+
+    // Newest first
+    text.clear();
+    size_t count = history.getTripCount();
+    for (size_t i = 0; i < RECENT_TRIPS && i < count; i++) {
+        TripRecord trip;
+        if (!history.getTrip(count - 1 - i, trip)) break;
+
+        time_t start = (time_t)trip.start_time;
+        struct tm local;
+        localtime_r(&start, &local);
+        char when[32];
+        strftime(when, sizeof(when), "%d.%m. %H:%M", &local);
+
+        double net_wh = trip.energy_used_wh - trip.energy_regen_wh;
+        char line[128];
+        snprintf(line, sizeof(line), "%s   %6.1f km   %4.0f min   avg %3.0f / max %3.0f km/h   %4.0f Wh/km   SOC %.0f-%.0f%%\n",
+                 when, trip.distance_km, (trip.end_time - trip.start_time) / 60.0,
+                 trip.speed_avg_kmh, trip.speed_max_kmh,
+                 trip.distance_km > 0.0f ? net_wh / trip.distance_km : 0.0, trip.soc_min, trip.soc_max);
+        text += line;
+    }
+    setLabelText(lbl_recent, count ? text.c_str() : "No trips recorded yet");
+}
@@ -0,0 +1,76 @@
+#include "ValueAnimator.h"
+#include <algorithm>
+
+ValueAnimator::~ValueAnimator() {
+    if (timer) lv_timer_delete(timer);
+}
+
+size_t ValueAnimator::add(ApplyFn apply) {
+    if (!timer) {
+        timer = lv_timer_create(timerCallback, LV_DEF_REFR_PERIOD, this);
+        lv_timer_pause(timer);
+    }
+    channels.emplace_back();
+    channels.back().apply = std::move(apply);
+    return channels.size() - 1;
+}
+
+void ValueAnimator::setTarget(size_t channel, float target) {
+    Channel& ch = channels[channel];
+    uint32_t now = lv_tick_get();
+
+    if (!ch.has_value) {
+        ch.has_value = true;
+        ch.active = false;
+        ch.from = ch.to = ch.current = target;
+        ch.last_target_ms = now;
+        ch.apply(target);
+        return;
+    }
+    if (target == ch.to) return;
+
+    // Glide over the last sample interval, starting from what is shown now
+    ch.from = ch.current;
+    ch.to = target;
+    ch.start_ms = now;
+    ch.duration_ms = std::min(std::max(now - ch.last_target_ms, MIN_DURATION_MS), MAX_DURATION_MS);
+    ch.last_target_ms = now;
+    ch.active = true;
+
+    if (paused) {
+        paused = false;
+        lv_timer_resume(timer);
+    }
+}
+
+void ValueAnimator::reset(size_t channel) {
+    channels[channel].has_value = false;
+    channels[channel].active = false;
+}
+
+void ValueAnimator::timerCallback(lv_timer_t* timer) {
+    ((ValueAnimator*)lv_timer_get_user_data(timer))->step();
+}
+
+void ValueAnimator::step() {
+    uint32_t now = lv_tick_get();
+    bool any_active = false;
+
+    for (Channel& ch : channels) {
+        if (!ch.active) continue;
+        uint32_t elapsed = now - ch.start_ms;   // Unsigned: wraps with the tick
+        if (elapsed >= ch.duration_ms) {
+            ch.current = ch.to;
+            ch.active = false;
+        } else {
+            ch.current = ch.from + (ch.to - ch.from) * elapsed / ch.duration_ms;
+            any_active = true;
+        }
+        ch.apply(ch.current);
+    }
+
+    if (!any_active) {
+        paused = true;
+        lv_timer_pause(timer);
+    }
+}
@@ -6,10 +6,48 @@
 #include <iostream>
 #include <cmath>
 #include <fstream>
+#include <memory>
+#include <string>
+#include <csignal>
+#include <cstdlib>
+#include <ctime>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include <stdexcept>
 
 // Project headers
 #include "SimplifiedAudioManager.h"  // NEW: Replace BluetoothAudioManager
 #include "SerialCommunication.h"
+#include "Trace.h"
+#include "MetricsExporter.h"
+#include "OdometerStore.h"
+#include "PersistenceWorker.h"
+#include "TripHistory.h"
+#include "EnergyAccumulator.h"
+#include "RangeEstimator.h"
+#include "CellStats.h"
+#include "CellHeatmap.h"
+#include "TripScreen.h"
+#include "EnergyScreen.h"
+#include "DiagnosticsScreen.h"
+#include "BatteryAlarms.h"
+#include "SignalConditioner.h"
+#include "TimeSeriesPyramid.h"
+#include "ChartFeed.h"
+#include "SpeedWidget.h"
+#include "LightingOverlay.h"
+#include "ValueAnimator.h"
+#include "PowerStateMachine.h"
+#include "RenderBenchmark.h"
+#include "SdlDisplay.h"
+#include "StaticLayerCache.h"
+#ifdef ASSET_PACK
+#include "AssetPack.h"
+#endif
+#ifdef ENABLE_TELEMETRY_LOG
+#include "TelemetryLogger.h"
+#endif
 
 // Include UI files
 extern "C" {
@@ -20,6 +58,48 @@ extern "C" {
 // Objects struct from EEZ Studio
 extern objects_t objects;
 
+// Captured during static initialization - used for boot timing metrics
+static const auto process_start_time = std::chrono::steady_clock::now();
+
+static long long msSinceProcessStart() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - process_start_time).count();
+}
+
+#ifdef ENABLE_TRACING
+// Render and flush spans come from LVGL display events
+static void traceDisplayEvent(lv_event_t* e) {
+    switch (lv_event_get_code(e)) {
+        case LV_EVENT_REFR_START:   TRACE_BEGIN("lv_refresh"); break;
+        case LV_EVENT_REFR_READY:   TRACE_END("lv_refresh"); break;
+        case LV_EVENT_RENDER_START: TRACE_BEGIN("lv_render"); break;
+        case LV_EVENT_RENDER_READY: TRACE_END("lv_render"); break;
+        case LV_EVENT_FLUSH_START:  TRACE_BEGIN("lv_flush"); break;
+        case LV_EVENT_FLUSH_FINISH: TRACE_END("lv_flush"); break;
+        default: break;
+    }
+}
+#endif
+
+// Set by SIGTERM/SIGPWR/SIGINT - the main loop exits and stop() does the final flush
+static volatile sig_atomic_t shutdown_signal = 0;
+
+static void onShutdownSignal(int signal_number) {
+    shutdown_signal = signal_number;
+}
+
+// Frame time = LVGL refresh start to ready (render + flush)
+static std::chrono::steady_clock::time_point refresh_start_time;
+
+static void frameTimeDisplayEvent(lv_event_t* e) {
+    LatencyHistogram* frame_time = (LatencyHistogram*)lv_event_get_user_data(e);
+    if (lv_event_get_code(e) == LV_EVENT_REFR_START) {
+        refresh_start_time = std::chrono::steady_clock::now();
+    } else {
+        frame_time->observeSince(refresh_start_time);
+    }
+}
+
 // EEZ Studio event handler infrastructure
 lv_event_t g_eez_event;
 bool g_eez_event_is_available = false;
@@ -40,22 +120,46 @@ class Dashboard {
 private:
     std::atomic<bool> running{true};
     
-    // Component managers
+    // Component managers - created by the background init thread and
+    // published through the *_ready flags below
     std::unique_ptr<SimplifiedAudioManager> audio_manager;  // CHANGED: Use simplified manager
     std::unique_ptr<SerialCommunication> serial_comm;
+    std::thread component_init_thread;
+    std::atomic<bool> serial_ready{false};
+    std::atomic<bool> audio_ready{false};
+    std::unique_ptr<MetricsExporter> metrics;
     
     // LVGL chart series
     lv_chart_series_t* voltage_series = nullptr;
     lv_chart_series_t* current_series = nullptr;
     
+    // Chart history - tap the chart to cycle the window. The 1 minute window
+    // comes from the ingest-rate feeds, the longer ones from the pyramid.
+    static constexpr size_t CHART_COLUMNS = ChartColumns::MAX_COLUMNS;
+    static constexpr int CHART_WINDOW_COUNT = 3;
+    static constexpr float VOLTAGE_CHART_SCALE = 10.0f;   // 0.1 V per chart unit
+    const uint64_t CHART_WINDOW_MS[CHART_WINDOW_COUNT] = {60000, 600000, 3600000};
+    const char* CHART_WINDOW_NAMES[CHART_WINDOW_COUNT] = {"1 min", "10 min", "1 h"};
+    TimeSeriesPyramid history;
+    ChartFeed voltage_feed{60000};
+    ChartFeed current_feed{60000};
+    ChartColumns chart_columns;
+    std::vector<HistoryBucket> chart_buckets = std::vector<HistoryBucket>(TimeSeriesPyramid::LEVEL_CAPACITY[0]);
+    int chart_window = 0;
+    int64_t chart_bucket = -1;   // Newest bucket on the chart; -1 forces a redraw
+    uint64_t chart_drawn_ms = 0;
+    ChartAxisRange voltage_axis;
+    ChartAxisRange current_axis;
+    lv_obj_t* lbl_chart_window = nullptr;
+    
     // Timing variables
     std::chrono::steady_clock::time_point last_update;
-    std::chrono::steady_clock::time_point last_odo_save;
     std::chrono::steady_clock::time_point startup_time;
+    std::chrono::steady_clock::time_point last_touch_time;
     
-    const int UPDATE_INTERVAL = 100;    // Update display every 100ms
-    const int ODO_SAVE_INTERVAL = 2000; // Save odo/trip every 2 seconds
+    const int STANDBY_WAIT = SdlDisplay::STANDBY_EVENT_MS;  // Longest poll() on the serial port in standby
     const int STARTUP_ICON_DURATION = 2000; // 2 seconds startup test
+    const int TRIP_IGNITION_OFF_TIMEOUT = 30000; // No vehicle data this long closes the trip
     
     // Vehicle data variables
     float speed_kmh = 0.0;
@@ -84,17 +188,102 @@ private:
     bool handbrake_on = false;
     bool light_on = false;
     
+    // Window, flush and touch; buffering from TAZZARI_RENDER_MODE etc.
+    SdlDisplay sdl_display;
+    
+    // Refresh, update and polling rates follow the vehicle state
+    PowerStateMachine power;
+    std::atomic<int> power_state{POWER_DRIVING};
+    
+#ifdef ASSET_PACK
+    // Must outlive every image object - pixels are drawn from the mapping
+    AssetPack asset_pack;
+#endif
+    
     // Startup state
     bool startup_icons_active = true;
+    lv_obj_t* splash_screen = nullptr;
+    bool live_data_logged = false;
+    
+    // Storage - all writes go through the persistence worker thread
+    OdometerStore odometer_store;
+    PersistenceWorker persistence{odometer_store};
+    bool soc_known = false;  // Stored or live SOC - shown until BMS data arrives
     
-    // Storage
-    float saved_odo = 0.0;
-    float saved_trip = 0.0;
+    // Trip history - appended on the persistence worker, queried on the UI thread
+    TripHistory trip_history;
+    TripAccumulator current_trip;
+    std::chrono::steady_clock::time_point last_vehicle_data_time;
+    
+    // Energy accounting from BMS frames
+    EnergyAccumulator energy{EnergyAccumulator::configFromEnvironment()};
+    lv_obj_t* lbl_energy = nullptr;
+    RangeEstimator range{RangeEstimator::configFromEnvironment()};
+    lv_obj_t* lbl_range = nullptr;
+    double recent_wh_per_km = 0.0;    // Shown next to the animated power
+    double trip_wh_per_km = 0.0;
+    
+    // Speed, SOC and power glide between display ticks
+    ValueAnimator animator;
+    size_t anim_speed = 0;
+    size_t anim_soc = 0;
+    size_t anim_power = 0;
+    
+    // Per-cell data - statistics every frame, heatmap only while it is shown
+    cell_data_t last_cells = {0};
+    CellStatistics cell_stats;
+    CellHeatmap cell_heatmap;
+    SpeedWidget speed_widget;
+    LightingOverlay lighting;
+    StaticLayerCache static_layer;
+    bool weak_cell_reported = false;
+    int reported_invalid_cells = 0;
+    std::atomic<uint32_t> cell_spread_mv{0};
+    std::atomic<uint32_t> cell_imbalance_uv{0};
+    
+    // Battery alarm rules, evaluated per BMS/cell frame
+    BatteryAlarms battery_alarms;
+    BatterySignals battery_signals;
+    AlarmSeverity shown_alarm = ALARM_NONE;
+    std::atomic<int> alarm_severity{ALARM_NONE};
+    
+    // Filtered speed/current/SOC for display; raw values still drive the
+    // odometer and energy integration
+    SignalConditioner conditioned;
+    std::atomic<float> acceleration_mps2{0.0f};
+    
+#ifdef ENABLE_TELEMETRY_LOG
+    // Every decoded packet, for post-drive analysis
+    TelemetryLogger telemetry;
+#endif
     
     // Audio state
-    bool audio_initialized = false;
+    std::atomic<bool> audio_initialized{false};
+    bool audio_controls_enabled = false;
+    
+    // Runtime metrics - written on the UI thread, read by the metrics exporter
+    LatencyHistogram loop_latency;
+    LatencyHistogram frame_time;
+    std::atomic<long long> boot_first_frame_ms{-1};
+    std::atomic<long long> boot_live_data_ms{-1};
+    std::atomic<uint64_t> lv_mem_used_bytes{0};
+    std::atomic<uint64_t> lv_mem_max_used_bytes{0};
+    std::atomic<uint32_t> lv_mem_frag_pct{0};
+    std::chrono::steady_clock::time_point last_mem_sample;
+    
+    // Detail screens right of the main screen, built on first visit
+    ScreenManager screens{ScreenManager::budgetFromEnvironment()};
+    EnergyScreen energy_screen{energy, range, history};
+    TripScreen trip_screen{trip_history};
+    DiagnosticsScreen diagnostics_screen{battery_alarms, loop_latency, frame_time};
     
 public:
+    ~Dashboard() {
+        if (component_init_thread.joinable()) {
+            component_init_thread.join();
+        }
+    }
+    
     void init() {
         std::cout << "=== LVGL Dashboard Starting Up ===" << std::endl;
         
@@ -105,64 +294,158 @@ public:
         // Initialize display based on build configuration
 #ifdef DEPLOYMENT_BUILD
         std::cout << "Boot: Creating fullscreen display..." << std::endl;
-        lv_display_t* disp = lv_sdl_window_create(1024, 600);
 #else
         std::cout << "Boot: Creating windowed display (1024x600)..." << std::endl;
-        lv_display_t* disp = lv_sdl_window_create(1024, 600);
 #endif
+#ifdef DEPLOYMENT_BUILD
+        lv_display_t* disp = sdl_display.create(1024, 600, true, SdlDisplayConfig::fromEnvironment());
+#else
+        lv_display_t* disp = sdl_display.create(1024, 600, false, SdlDisplayConfig::fromEnvironment());
+#endif
+        if (!disp) {
+            throw std::runtime_error("Cannot create display");
+        }
+        
+#ifdef ENABLE_TRACING
+        // kill -USR1 <pid> writes the trace buffers to trace_<ms>.json
+        Trace::setThreadName("ui");
+        Trace::initFromEnvironment();
+        Trace::installDumpSignal(SIGUSR1);
+        lv_display_add_event_cb(disp, traceDisplayEvent, LV_EVENT_ALL, nullptr);
+#endif
+        
+        // Get a first frame on screen before anything slow runs
+        showSplash(disp);
+        boot_first_frame_ms = msSinceProcessStart();
+        std::cout << "Boot: First frame after " << boot_first_frame_ms << "ms" << std::endl;
         
-        lv_indev_t* indev = lv_sdl_mouse_create();
+        lv_display_add_event_cb(disp, frameTimeDisplayEvent, LV_EVENT_REFR_START, &frame_time);
+        lv_display_add_event_cb(disp, frameTimeDisplayEvent, LV_EVENT_REFR_READY, &frame_time);
+        
+#ifdef ENABLE_METRICS
+        startMetrics();
+#endif
         
         // Initialize UI
         std::cout << "Boot: Initializing UI..." << std::endl;
+#ifdef ASSET_PACK
+        asset_pack.open(AssetPack::defaultPath());
+        asset_pack.registerDecoder();
+#endif
         ui_init();
+        // Before adding our own widgets: only EEZ's unnamed objects are static
+        attachStaticLayer();
         setupChartSeries();
+        setupEnergyDisplay();
+        setupScreens();
+        speed_widget.attach(objects.lbl_speed);
+        setupLighting();
+        setupAnimations();
+        disableAudioControls();
         
-        // Initialize components
-        initializeComponents();
-        
-        // Load saved data
+        // Load saved data and show it right away
         loadFromStorage();
+        updateDisplay();
+        static_layer.rebuild();
+        
+        // TAZZARI_RENDER_BENCH=<frames>: measure fixed scenes and exit
+        if (uint32_t bench_frames = RenderBenchmark::framesFromEnvironment()) {
+            runRenderBenchmark(disp, bench_frames);
+            running = false;
+            return;
+        }
+        
+#ifdef ENABLE_TELEMETRY_LOG
+        telemetry.start();
+#endif
+        
+        // Serial and audio setup can take seconds (DSP wait, curl, bluetoothctl)
+        // so they finish in the background and light up when ready
+        component_init_thread = std::thread(&Dashboard::initializeComponents, this);
         
         // Initialize timing
         auto now = std::chrono::steady_clock::now();
         last_update = now;
-        last_odo_save = now;
         startup_time = now;
         
         // Show startup icons
         showAllIconsStartup();
         setGear(GEAR_N);
         
-        std::cout << "=== Dashboard Ready! ===" << std::endl;
+        std::cout << "=== Dashboard Ready! (" << msSinceProcessStart() << "ms) ===" << std::endl;
+    }
+    
+    // Same scenes in both colour depth profiles; each step changes the UI
+    // the way driving does
+    void runRenderBenchmark(lv_display_t* disp, uint32_t frames) {
+        lv_screen_load(objects.main);
+        hideAllIcons();
+        
+        RenderBenchmark bench(disp);
+        bench.addScene("idle", [](uint32_t) {});
+        bench.addScene("speed", [this](uint32_t frame) {
+            speed_widget.setValue(frame % 130);
+        });
+        bench.addScene("power chart", [](uint32_t) {
+            lv_obj_invalidate(objects.cht_pwusage);
+        });
+        bench.addScene("light overlays", [this](uint32_t frame) {
+            lighting.setLights(frame % 2 ? LAMP_LOWBEAM | LAMP_REAR : 0);
+        });
+        bench.addScene("full screen", [](uint32_t) {
+            lv_obj_invalidate(lv_screen_active());
+        });
+        bench.run(frames, std::cout);
+    }
+    
+    void showSplash(lv_display_t* disp) {
+        splash_screen = lv_obj_create(NULL);
+        lv_obj_set_style_bg_color(splash_screen, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
+        
+        lv_obj_t* img = lv_image_create(splash_screen);
+        lv_image_set_src(img, "A:img/splash.png");
+        lv_obj_center(img);
+        
+        lv_screen_load(splash_screen);
+        lv_refr_now(disp);
     }
     
     void initializeComponents() {
-        std::cout << "Boot: Initializing components..." << std::endl;
+        std::cout << "Boot: Initializing components in background..." << std::endl;
+#ifdef ENABLE_TRACING
+        Trace::setThreadName("component_init");
+#endif
         
         // Initialize Serial Communication
-        serial_comm = std::make_unique<SerialCommunication>("/dev/ttyACM0", 115200);
-        if (!serial_comm->initialize()) {
+        auto serial = std::make_unique<SerialCommunication>("/dev/ttyACM0", 115200);
+        if (!serial->initialize()) {
             std::cout << "Warning: Serial communication failed - running without vehicle data" << std::endl;
         }
         
-        // Set up serial callbacks
-        serial_comm->setAutomotiveDataCallback([this](const automotive_data_t& data) {
+        // Set up serial callbacks (invoked from processData() on the UI thread)
+        serial->setAutomotiveDataCallback([this](const automotive_data_t& data) {
             processAutomotiveData(data);
         });
         
-        serial_comm->setBMSDataCallback([this](const bms_data_t& data) {
+        serial->setBMSDataCallback([this](const bms_data_t& data) {
             processBMSData(data);
         });
         
+        serial->setCellDataCallback([this](const cell_data_t& data) {
+            processCellData(data);
+        });
+        
+        serial_comm = std::move(serial);
+        serial_ready = true;
+        std::cout << "Boot: Serial ready after " << msSinceProcessStart() << "ms" << std::endl;
+        
         // Initialize Simplified Audio Manager (CHANGED)
         std::cout << "Boot: Initializing Simplified Audio Manager..." << std::endl;
-        audio_manager = std::make_unique<SimplifiedAudioManager>();
-        if (audio_manager->initialize()) {
-            audio_initialized = true;
-            
-            // Set up audio state callback
-            audio_manager->setStateCallback([this](const SimpleMediaInfo& info) {
+        auto audio = std::make_unique<SimplifiedAudioManager>();
+        bool audio_ok = audio->initialize();
+        if (audio_ok) {
+            // Set up audio state callback (invoked from update() on the UI thread)
+            audio->setStateCallback([this](const SimpleMediaInfo& info) {
                 updateAudioDisplay(info);
             });
             
@@ -170,34 +453,239 @@ public:
         } else {
             std::cout << "Warning: Audio initialization failed" << std::endl;
         }
+        
+        audio_manager = std::move(audio);
+        audio_initialized = audio_ok;
+        audio_ready = true;
+        std::cout << "Boot: Audio ready after " << msSinceProcessStart() << "ms" << std::endl;
+    }
+    
+    bool isBMSLive() {
+        return bms_connected && serial_ready && serial_comm->isBMSDataValid();
+    }
+    
+    void logLiveData() {
+        if (live_data_logged) return;
+        live_data_logged = true;
+        boot_live_data_ms = msSinceProcessStart();
+        std::cout << "Boot: First live vehicle data after " << boot_live_data_ms << "ms" << std::endl;
+    }
+    
+    void startMetrics() {
+        int port = 9110;
+        if (const char* env = std::getenv("TAZZARI_METRICS_PORT")) {
+            port = std::atoi(env);
+        }
+        
+        metrics = std::make_unique<MetricsExporter>(port);
+        metrics->addCollector([this](std::ostream& out) {
+            writeMetrics(out);
+        });
+        if (!metrics->start()) {
+            metrics.reset();
+        }
+    }
+    
+    // Called on the exporter thread - only atomics and thread-safe stats
+    void writeMetrics(std::ostream& out) {
+        loop_latency.write(out, "tazzari_loop_latency_seconds", "Main loop iteration time excluding sleep");
+        frame_time.write(out, "tazzari_frame_time_seconds", "LVGL refresh time (render + flush)");
+        
+        MetricsExporter::writeGauge(out, "tazzari_boot_first_frame_ms", "Process start to first frame", boot_first_frame_ms);
+        MetricsExporter::writeGauge(out, "tazzari_boot_live_data_ms", "Process start to first vehicle frame (-1 = none yet)", boot_live_data_ms);
+        
+        MetricsExporter::writeGauge(out, "tazzari_lvgl_mem_used_bytes", "LVGL heap in use", lv_mem_used_bytes);
+        MetricsExporter::writeGauge(out, "tazzari_lvgl_mem_max_used_bytes", "LVGL heap high-water mark", lv_mem_max_used_bytes);
+        MetricsExporter::writeGauge(out, "tazzari_lvgl_mem_frag_percent", "LVGL heap fragmentation", lv_mem_frag_pct);
+        
+        MetricsExporter::writeGauge(out, "tazzari_power_state", "0 driving, 1 parked, 2 charging, 3 ignition off, 4 standby", power_state);
+        MetricsExporter::writeGauge(out, "tazzari_battery_alarm_severity", "Highest active battery alarm (0 none, 1 info, 2 warning, 3 critical)", alarm_severity);
+        MetricsExporter::writeGauge(out, "tazzari_acceleration_mps2", "Longitudinal acceleration from the filtered speed", acceleration_mps2.load());
+        MetricsExporter::writeGauge(out, "tazzari_cell_spread_mv", "Highest minus lowest cell voltage", cell_spread_mv);
+        MetricsExporter::writeGauge(out, "tazzari_cell_imbalance_uv", "Standard deviation of the cell voltages", cell_imbalance_uv);
+        
+        MetricsExporter::writeCounter(out, "tazzari_storage_writes_total", "ODO/trip storage writes", odometer_store.getWriteCount());
+        MetricsExporter::writeCounter(out, "tazzari_storage_snapshots_total", "State snapshots handed to the persistence worker", persistence.getSubmitted());
+        MetricsExporter::writeCounter(out, "tazzari_storage_bytes_written_total", "Bytes written to the odometer journal", odometer_store.getBytesWritten());
+        MetricsExporter::writeGauge(out, "tazzari_storage_recovery_us", "Odometer journal recovery time at startup", odometer_store.getRecoveryTimeUs());
+        
+#ifdef ENABLE_TELEMETRY_LOG
+        MetricsExporter::writeCounter(out, "tazzari_telemetry_records_total", "Packets recorded to the telemetry log", telemetry.getRecords());
+        MetricsExporter::writeCounter(out, "tazzari_telemetry_raw_bytes_total", "Size of the recorded packets as raw structs", telemetry.getRawBytes());
+        MetricsExporter::writeCounter(out, "tazzari_telemetry_written_bytes_total", "Bytes written to telemetry logs and indexes", telemetry.getWrittenBytes());
+        MetricsExporter::writeCounter(out, "tazzari_telemetry_dropped_total", "Packets dropped by the telemetry logger", telemetry.getDropped());
+#endif
+        
+        if (serial_ready) {
+            const SerialStats& stats = serial_comm->getStats();
+            MetricsExporter::writeCounter(out, "tazzari_serial_bytes_total", "Bytes read from the ESP32 link", stats.bytes_received);
+            MetricsExporter::writeCounter(out, "tazzari_serial_bms_frames_total", "Valid BMS frames", stats.bms_packets);
+            MetricsExporter::writeCounter(out, "tazzari_serial_auto_frames_total", "Valid automotive frames", stats.auto_packets);
+            MetricsExporter::writeCounter(out, "tazzari_serial_cell_frames_total", "Valid per-cell frames", stats.cell_packets);
+            MetricsExporter::writeCounter(out, "tazzari_serial_checksum_errors_total", "Frames dropped on checksum mismatch", stats.checksum_errors);
+            MetricsExporter::writeCounter(out, "tazzari_serial_framing_errors_total", "Frames dropped on bad type, length or end byte", stats.framing_errors);
+        }
+        
+        if (audio_ready) {
+            audio_manager->getRestLatency().write(out, "tazzari_audio_rest_call_seconds", "BeoCreate DSP REST call latency");
+            MetricsExporter::writeCounter(out, "tazzari_audio_rest_failures_total", "Failed DSP REST calls", audio_manager->getRestFailures());
+        }
+    }
+    
+    // lv_mem_monitor() is not thread safe - sample on the UI thread
+    void sampleLvglMemory(std::chrono::steady_clock::time_point now) {
+        if (now - last_mem_sample < std::chrono::seconds(1)) return;
+        last_mem_sample = now;
+        
+        lv_mem_monitor_t mon;
+        lv_mem_monitor(&mon);
+        lv_mem_used_bytes = mon.total_size - mon.free_size;
+        lv_mem_max_used_bytes = mon.max_used;
+        lv_mem_frag_pct = mon.frag_pct;
+    }
+    
+    void disableAudioControls() {
+        lv_obj_add_state(objects.arc_volume, LV_STATE_DISABLED);
+        lv_obj_add_state(objects.sld_base, LV_STATE_DISABLED);
+        lv_obj_add_state(objects.sld_mid, LV_STATE_DISABLED);
+        lv_obj_add_state(objects.sld_high, LV_STATE_DISABLED);
+        lv_obj_set_style_opa(objects.btn_play, LV_OPA_50, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_opa(objects.btn_skip, LV_OPA_50, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_opa(objects.btn_back, LV_OPA_50, LV_PART_MAIN | LV_STATE_DEFAULT);
+    }
+    
+    void enableAudioControls() {
+        lv_obj_clear_state(objects.arc_volume, LV_STATE_DISABLED);
+        lv_obj_clear_state(objects.sld_base, LV_STATE_DISABLED);
+        lv_obj_clear_state(objects.sld_mid, LV_STATE_DISABLED);
+        lv_obj_clear_state(objects.sld_high, LV_STATE_DISABLED);
+        lv_obj_set_style_opa(objects.btn_play, LV_OPA_COVER, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_opa(objects.btn_skip, LV_OPA_COVER, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_opa(objects.btn_back, LV_OPA_COVER, LV_PART_MAIN | LV_STATE_DEFAULT);
     }
     
     void setupChartSeries() {
         voltage_series = lv_chart_add_series(objects.cht_pwusage, lv_color_hex(0xFF0000), LV_CHART_AXIS_PRIMARY_Y);
-        current_series = lv_chart_add_series(objects.cht_pwusage, lv_color_hex(0x0000FF), LV_CHART_AXIS_PRIMARY_Y);
+        current_series = lv_chart_add_series(objects.cht_pwusage, lv_color_hex(0x0000FF), LV_CHART_AXIS_SECONDARY_Y);
         
-        // Initialize with default values
-        for(int i = 0; i < 10; i++) {
-            lv_chart_set_next_value(objects.cht_pwusage, voltage_series, 0);
-            lv_chart_set_next_value(objects.cht_pwusage, current_series, 200);
-        }
+        // A min and a max point per pixel column, rewritten on each redraw
+        lv_chart_set_point_count(objects.cht_pwusage, CHART_COLUMNS * 2);
+        lv_chart_set_all_value(objects.cht_pwusage, voltage_series, LV_CHART_POINT_NONE);
+        lv_chart_set_all_value(objects.cht_pwusage, current_series, LV_CHART_POINT_NONE);
+        
+        lbl_chart_window = lv_label_create(objects.cht_pwusage);
+        lv_obj_set_style_text_font(lbl_chart_window, &lv_font_montserrat_16, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_align(lbl_chart_window, LV_ALIGN_TOP_RIGHT, 0, 0);
+        lv_label_set_text(lbl_chart_window, CHART_WINDOW_NAMES[chart_window]);
+        
+        lv_obj_add_event_cb(objects.cht_pwusage, [](lv_event_t* e) {
+            Dashboard* self = (Dashboard*)lv_event_get_user_data(e);
+            self->chart_window = (self->chart_window + 1) % CHART_WINDOW_COUNT;
+            self->chart_bucket = -1;
+            self->chart_drawn_ms = 0;
+            lv_label_set_text(self->lbl_chart_window, self->CHART_WINDOW_NAMES[self->chart_window]);
+            self->updateCurrentGraph();
+        }, LV_EVENT_CLICKED, this);
         
         std::cout << "Charts: Series created - Voltage (red), Current (blue)" << std::endl;
     }
     
+    // Power and consumption readout above the power chart (not part of the EEZ project)
+    void setupEnergyDisplay() {
+        lbl_energy = lv_label_create(objects.main);
+        lv_obj_set_style_text_font(lbl_energy, &lv_font_montserrat_16, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_text_align(lbl_energy, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_label_set_text(lbl_energy, "");
+        lv_obj_align_to(lbl_energy, objects.cht_pwusage, LV_ALIGN_OUT_TOP_MID, 0, -4);
+        
+        lbl_range = lv_label_create(objects.main);
+        lv_obj_set_style_text_font(lbl_range, &lv_font_montserrat_16, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_label_set_text(lbl_range, "");
+        lv_obj_align_to(lbl_range, objects.bar_soc, LV_ALIGN_OUT_TOP_MID, 0, -4);
+    }
+    
+    // Apply callbacks round to what each widget shows, so a glide only
+    // redraws when the shown value moves
+    void setupAnimations() {
+        anim_speed = animator.add([this](float kmh) {
+            speed_widget.setValue((int)lroundf(kmh));
+        });
+        anim_soc = animator.add([](float percent) {
+            char buffer[16];
+            int shown = (int)lroundf(percent);
+            snprintf(buffer, sizeof(buffer), "%d%%", shown);
+            setLabelText(objects.lbl_soc, buffer);
+            lv_bar_set_value(objects.bar_soc, shown, LV_ANIM_OFF);
+        });
+        anim_power = animator.add([this](float kw) {
+            showEnergy(kw);
+        });
+    }
+    
+    void showEnergy(float power_kw) {
+        char buffer[48];
+        snprintf(buffer, sizeof(buffer), "%.1f kW  %.0f | %.0f Wh/km", power_kw, recent_wh_per_km, trip_wh_per_km);
+        setLabelText(lbl_energy, buffer);
+    }
+    
+    // Swipe order: main, cells, energy, trips, diagnostics. Tap the SOC
+    // bar for the cell heatmap, tap the heatmap to go back
+    void setupScreens() {
+        std::cout << "Cells: Statistics kernel " << CellStats::kernelName() << std::endl;
+        cell_heatmap.setSource(&last_cells, &cell_stats);
+        
+        screens.setHome(objects.main);
+        screens.add(&cell_heatmap);
+        screens.add(&energy_screen);
+        screens.add(&trip_screen);
+        screens.add(&diagnostics_screen);
+        
+        lv_obj_add_flag(objects.bar_soc, LV_OBJ_FLAG_CLICKABLE);
+        lv_obj_add_event_cb(objects.bar_soc, [](lv_event_t* e) {
+            Dashboard* self = (Dashboard*)lv_event_get_user_data(e);
+            self->screens.show(&self->cell_heatmap);
+        }, LV_EVENT_CLICKED, this);
+    }
+    
+    // Every EEZ object with a name may change at runtime; only the unnamed
+    // ones (captions, car image) are flattened into the static layer
+    void attachStaticLayer() {
+        lv_obj_t* const named[] = {
+            objects.arc_volume, objects.bar_soc, objects.bass, objects.btn_back, objects.btn_play,
+            objects.btn_skip, objects.cht_pwusage, objects.high, objects.img_album, objects.img_drl,
+            objects.img_fogrear, objects.img_highbeam, objects.img_icon_bat, objects.img_icon_break,
+            objects.img_icon_drl, objects.img_icon_fog_rear, objects.img_icon_highbeam,
+            objects.img_icon_ind_left, objects.img_icon_ind_right, objects.img_icon_light,
+            objects.img_icon_lowbeam, objects.img_icon_park, objects.img_lowbeam, objects.img_rearlight,
+            objects.img_reverselight, objects.lbl_gear_d, objects.lbl_gear_n, objects.lbl_gear_r,
+            objects.lbl_odo, objects.lbl_soc, objects.lbl_speed, objects.lbl_temp_min_max, objects.lbl_trip,
+            objects.lbl_volt_min_max, objects.mid, objects.play, objects.sld_base, objects.sld_high,
+            objects.sld_mid,
+        };
+        // A new EEZ object has to be listed above, or it could be flattened
+        // (+1: objects.main is the screen itself)
+        static_assert(sizeof(objects_t) == (sizeof(named) / sizeof(named[0]) + 1) * sizeof(lv_obj_t*),
+                      "objects_t changed - update the named object list");
+        static_layer.attach(objects.main, named, sizeof(named) / sizeof(named[0]));
+    }
+    
+    // Overlay images in LightingLamp bit order
+    void setupLighting() {
+        lv_obj_t* const images[LightingOverlay::LAMPS] = {
+            objects.img_highbeam, objects.img_lowbeam, objects.img_drl,
+            objects.img_rearlight, objects.img_reverselight, objects.img_fogrear
+        };
+        lighting.attach(images);
+    }
+    
     // Startup icon display
     void showAllIconsStartup() {
-        lv_obj_clear_flag(objects.img_reverselight, LV_OBJ_FLAG_HIDDEN);
+        lighting.setLights(LAMP_ALL);
         lv_obj_clear_flag(objects.img_icon_drl, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_clear_flag(objects.img_drl, LV_OBJ_FLAG_HIDDEN);
         lv_obj_clear_flag(objects.img_icon_highbeam, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_clear_flag(objects.img_highbeam, LV_OBJ_FLAG_HIDDEN);
         lv_obj_clear_flag(objects.img_icon_light, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_clear_flag(objects.img_lowbeam, LV_OBJ_FLAG_HIDDEN);
         lv_obj_clear_flag(objects.img_icon_fog_rear, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_clear_flag(objects.img_fogrear, LV_OBJ_FLAG_HIDDEN);
         lv_obj_clear_flag(objects.img_icon_park, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_clear_flag(objects.img_rearlight, LV_OBJ_FLAG_HIDDEN);
         lv_obj_clear_flag(objects.img_icon_ind_left, LV_OBJ_FLAG_HIDDEN);
         lv_obj_clear_flag(objects.img_icon_ind_right, LV_OBJ_FLAG_HIDDEN);
         lv_obj_clear_flag(objects.img_icon_break, LV_OBJ_FLAG_HIDDEN);
@@ -205,17 +693,12 @@ public:
     }
     
     void hideAllIcons() {
-        lv_obj_add_flag(objects.img_reverselight, LV_OBJ_FLAG_HIDDEN);
+        lighting.setLights(0);
         lv_obj_add_flag(objects.img_icon_drl, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_add_flag(objects.img_drl, LV_OBJ_FLAG_HIDDEN);
         lv_obj_add_flag(objects.img_icon_highbeam, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_add_flag(objects.img_highbeam, LV_OBJ_FLAG_HIDDEN);
         lv_obj_add_flag(objects.img_icon_light, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_add_flag(objects.img_lowbeam, LV_OBJ_FLAG_HIDDEN);
         lv_obj_add_flag(objects.img_icon_fog_rear, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_add_flag(objects.img_fogrear, LV_OBJ_FLAG_HIDDEN);
         lv_obj_add_flag(objects.img_icon_park, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_add_flag(objects.img_rearlight, LV_OBJ_FLAG_HIDDEN);
         lv_obj_add_flag(objects.img_icon_ind_left, LV_OBJ_FLAG_HIDDEN);
         lv_obj_add_flag(objects.img_icon_ind_right, LV_OBJ_FLAG_HIDDEN);
         lv_obj_add_flag(objects.img_icon_break, LV_OBJ_FLAG_HIDDEN);
@@ -243,7 +726,24 @@ public:
     }
     
     void processAutomotiveData(const automotive_data_t& data) {
+        TRACE_SCOPE("processAutomotiveData");
+#ifdef ENABLE_TELEMETRY_LOG
+        telemetry.logAutomotive(data);
+#endif
+        logLiveData();
         speed_kmh = data.speed_kmh;
+        conditioned.addSpeed(data.speed_kmh, data.timestamp);
+        acceleration_mps2 = conditioned.getAcceleration();
+        last_vehicle_data_time = std::chrono::steady_clock::now();
+        
+        // First movement after ignition-on starts a trip
+        if (!current_trip.isActive() && speed_kmh > 0.0f) {
+            current_trip.start(time(nullptr));
+            std::cout << "Trip: Started" << std::endl;
+        }
+        if (current_trip.isActive()) {
+            current_trip.addSpeed(speed_kmh);
+        }
         
         // Map lighting states
         lowbeam_on = data.abblendlicht;
@@ -270,7 +770,12 @@ public:
     }
     
     void processBMSData(const bms_data_t& data) {
+        TRACE_SCOPE("processBMSData");
+#ifdef ENABLE_TELEMETRY_LOG
+        telemetry.logBMS(data);
+#endif
         if (!data.dataValid) return;
+        logLiveData();
         
         current_a = data.current;
         voltage_v = data.totalVoltage;
@@ -280,6 +785,113 @@ public:
         min_temp = data.minTemp;
         max_temp = data.maxTemp;
         bms_connected = true;
+        soc_known = true;
+        conditioned.addSoc(data.soc, data.timestamp);
+        
+        uint64_t now_ms = uptimeMs();
+        history.add(HISTORY_VOLTAGE, data.totalVoltage, now_ms);
+        history.add(HISTORY_CURRENT, data.current, now_ms);
+        history.add(HISTORY_POWER, -data.totalVoltage * data.current / 1000.0f, now_ms);
+        history.add(HISTORY_SOC, data.soc, now_ms);
+        history.add(HISTORY_TEMP_MIN, data.minTemp, now_ms);
+        history.add(HISTORY_TEMP_MAX, data.maxTemp, now_ms);
+        voltage_feed.add(data.totalVoltage, now_ms);
+        current_feed.add(data.current, now_ms);
+        
+        battery_signals.set(SIGNAL_CELL_MAX_V, data.maxVoltage);
+        battery_signals.set(SIGNAL_CELL_MIN_V, data.minVoltage);
+        battery_signals.set(SIGNAL_TEMP_MAX, data.maxTemp);
+        battery_signals.set(SIGNAL_TEMP_MIN, data.minTemp);
+        battery_signals.set(SIGNAL_SOC, data.soc);
+        battery_signals.set(SIGNAL_CURRENT, data.current);
+        evaluateAlarms();
+        
+        EnergyTotals step = energy.addFrame(data.totalVoltage, data.current, data.timestamp);
+        if (current_trip.isActive()) {
+            current_trip.addBattery(data.soc, data.minTemp, data.maxTemp);
+            current_trip.addEnergy(step.used_wh, step.regen_wh);
+        }
+    }
+    
+    uint64_t uptimeMs() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startup_time).count();
+    }
+    
+    void updatePowerState(std::chrono::steady_clock::time_point now) {
+        // Silence counts from startup until the first vehicle frame
+        auto last_frame = std::max(last_vehicle_data_time, startup_time);
+        if (sdl_display.takeActivity()) {
+            last_touch_time = now;
+        }
+        auto last_activity = std::max(last_frame, last_touch_time);
+        
+        PowerInputs inputs;
+        inputs.vehicle_live = serial_ready && serial_comm->isAutomotiveDataValid();
+        inputs.silent_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_frame).count();
+        inputs.idle_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_activity).count();
+        inputs.speed_kmh = speed_kmh;
+        inputs.in_gear = gear != GEAR_N;
+        inputs.handbrake = handbrake_on;
+        inputs.bms_live = isBMSLive();
+        inputs.current_a = current_a;
+        
+        PowerState previous = power.getState();
+        if (!power.update(inputs, uptimeMs())) return;
+        
+        const PowerProfile& profile = power.getProfile();
+        sdl_display.setTimerPeriods(profile.refresh_ms, profile.input_ms);
+        if (previous == POWER_STANDBY) {
+            // Whatever changed while asleep
+            lv_obj_invalidate(lv_screen_active());
+        }
+        power_state = power.getState();
+        std::cout << "Power: " << PowerStateMachine::stateName(previous) << " -> "
+                  << PowerStateMachine::stateName(power.getState()) << std::endl;
+    }
+    
+    // BMS went stale: the battery UI shows "No BMS" from the next update, and
+    // alarms and the current/SOC filters start over from the first frame
+    // after the reconnect
+    void onBMSLost() {
+        conditioned.resetBattery();
+        battery_alarms.reset();
+        battery_signals = BatterySignals();
+        alarm_severity = ALARM_NONE;
+        std::cout << "Alarms: BMS data lost - alarms reset" << std::endl;
+    }
+    
+    void evaluateAlarms() {
+        if (battery_alarms.evaluate(battery_signals, (uint32_t)uptimeMs())) {
+            alarm_severity = battery_alarms.getSeverity();
+        }
+    }
+    
+    void processCellData(const cell_data_t& data) {
+        TRACE_SCOPE("processCellData");
+        last_cells = data;
+        cell_stats = CellStats::compute(data);
+        cell_spread_mv = cell_stats.spread_mv;
+        cell_imbalance_uv = (uint32_t)(cell_stats.imbalance_mv * 1000.0f);
+        if (cell_stats.valid_count > 0) {
+            battery_signals.set(SIGNAL_CELL_SPREAD_MV, cell_stats.spread_mv);
+            evaluateAlarms();
+        }
+        if (cell_stats.invalid_count != reported_invalid_cells) {
+            std::cout << "Cells: " << cell_stats.invalid_count << " of " << cell_stats.cell_count
+                      << " readings out of range (sensor fault) - left out of the statistics" << std::endl;
+            reported_invalid_cells = cell_stats.invalid_count;
+        }
+        
+        // Report a weak cell once per episode; half the threshold clears it
+        float sag = cell_stats.weakCellSagMv();
+        if (!weak_cell_reported && cell_stats.valid_count > 0 && sag >= CellHeatmapConfig().weak_sag_mv) {
+            std::cout << "Cells: Cell " << cell_stats.min_index + 1 << " at " << cell_stats.min_mv
+                      << "mV, " << sag << "mV below the pack mean" << std::endl;
+            weak_cell_reported = true;
+        } else if (weak_cell_reported && sag < CellHeatmapConfig().weak_sag_mv / 2) {
+            weak_cell_reported = false;
+        }
     }
     
     // CHANGED: Simplified audio display update
@@ -330,87 +942,188 @@ public:
         // }
     }
     
+    // lv_label_set_text always invalidates; skip it when the text is the same
+    static void setLabelText(lv_obj_t* label, const char* text) {
+        if (strcmp(lv_label_get_text(label), text) != 0) {
+            lv_label_set_text(label, text);
+        }
+    }
+    
     void updateDisplay() {
-        char buffer[32];
+        TRACE_SCOPE("updateDisplay");
+        char buffer[48];
         
         // Update speed
-        snprintf(buffer, sizeof(buffer), "%.0f", speed_kmh);
-        lv_label_set_text(objects.lbl_speed, buffer);
+        animator.setTarget(anim_speed, conditioned.getSpeed().getDisplay());
         
         // Update odometer
         snprintf(buffer, sizeof(buffer), "%.1f", odo_km);
-        lv_label_set_text(objects.lbl_odo, buffer);
+        setLabelText(objects.lbl_odo, buffer);
         
         // Update trip
         snprintf(buffer, sizeof(buffer), "%.1f", trip_km);
-        lv_label_set_text(objects.lbl_trip, buffer);
+        setLabelText(objects.lbl_trip, buffer);
         
-        // Update SOC
-        if (bms_connected && serial_comm->isBMSDataValid()) {
-            snprintf(buffer, sizeof(buffer), "%.0f%%", (float)soc_percent);
-            lv_label_set_text(objects.lbl_soc, buffer);
-            lv_bar_set_value(objects.bar_soc, soc_percent, LV_ANIM_ON);
+        // Update SOC (last known value until the BMS reports in)
+        bool bms_live = isBMSLive();
+        if (bms_live || soc_known) {
+            const SignalFilter& soc = conditioned.getSoc();
+            int shown_soc = bms_live && soc.hasValue() ? (int)soc.getDisplay() : soc_percent;
+            animator.setTarget(anim_soc, shown_soc);
         } else {
-            lv_label_set_text(objects.lbl_soc, "No BMS");
+            animator.reset(anim_soc);
+            setLabelText(objects.lbl_soc, "No BMS");
         }
         
         // Update voltage range
-        if (bms_connected && serial_comm->isBMSDataValid()) {
+        if (bms_live) {
             snprintf(buffer, sizeof(buffer), "%.2f-%.2fV", min_cell_voltage, max_cell_voltage);
-            lv_label_set_text(objects.lbl_volt_min_max, buffer);
+            setLabelText(objects.lbl_volt_min_max, buffer);
         } else {
-            lv_label_set_text(objects.lbl_volt_min_max, "No BMS");
+            setLabelText(objects.lbl_volt_min_max, "No BMS");
         }
         
         // Update temperature range
-        if (bms_connected && serial_comm->isBMSDataValid()) {
+        if (bms_live) {
             snprintf(buffer, sizeof(buffer), "%.0f-%.0f°C", min_temp, max_temp);
-            lv_label_set_text(objects.lbl_temp_min_max, buffer);
+            setLabelText(objects.lbl_temp_min_max, buffer);
         } else {
-            lv_label_set_text(objects.lbl_temp_min_max, "No BMS");
+            setLabelText(objects.lbl_temp_min_max, "No BMS");
+        }
+        
+        // Power and consumption (middle window, trip counter)
+        if (bms_live) {
+            const EnergyTotals& trip_energy = energy.getTrip();
+            recent_wh_per_km = energy.getWindow(1).whPerKm();
+            trip_wh_per_km = trip_km > 0.2f ? trip_energy.netWh() / trip_km : 0.0;
+            animator.setTarget(anim_power, energy.getPowerKw());
+            showEnergy(animator.getValue(anim_power));
+        } else {
+            animator.reset(anim_power);
+            setLabelText(lbl_energy, "");
+        }
+        
+        // Remaining range with its confidence band
+        const RangeEstimate& estimate = range.getEstimate();
+        if (estimate.valid) {
+            snprintf(buffer, sizeof(buffer), "%.0f km (%.0f-%.0f)", estimate.km, estimate.low_km, estimate.high_km);
+            setLabelText(lbl_range, buffer);
+        } else {
+            setLabelText(lbl_range, "--- km");
         }
     }
     
+    // Called every loop iteration; draws at most once per display frame
     void updateCurrentGraph() {
-        // Add voltage to chart (scaled)
-        int32_t voltage_chart_value = (int32_t)(voltage_v * 10);
-        lv_chart_set_next_value(objects.cht_pwusage, voltage_series, voltage_chart_value);
+        uint64_t now_ms = uptimeMs();
+        uint32_t chart_ms = power.getProfile().chart_ms;
+        if (chart_ms == 0 || now_ms - chart_drawn_ms < chart_ms) return;
         
-        // Add current to chart (absolute value, scaled)
-        int32_t current_chart_value = (int32_t)(abs(current_a) / 10.0);
-        if (current_chart_value > 65) current_chart_value = 65;
-        if (current_chart_value < 0) current_chart_value = 0;
+        // Both flags are consumed so a redraw covers everything since the last one
+        bool voltage_fresh = voltage_feed.takeDirty();
+        bool current_fresh = current_feed.takeDirty();
+        uint64_t window_ms = CHART_WINDOW_MS[chart_window];
         
-        lv_chart_set_next_value(objects.cht_pwusage, current_series, current_chart_value);
+        if (window_ms <= voltage_feed.getWindowMs()) {
+            // Live window straight from the ingest-rate rings
+            if (!voltage_fresh && !current_fresh && chart_bucket != -1) return;
+            TRACE_SCOPE("updateCurrentGraph");
+            chart_bucket = 0;
+            
+            float lo, hi;
+            voltage_feed.decimate(now_ms, CHART_COLUMNS, chart_columns);
+            drawChartSeries(voltage_series, chart_columns, VOLTAGE_CHART_SCALE);
+            if (voltage_feed.extrema(now_ms, lo, hi)) {
+                scaleChartAxis(LV_CHART_AXIS_PRIMARY_Y, lo, hi, VOLTAGE_CHART_SCALE, 10, voltage_axis);
+            }
+            
+            current_feed.decimate(now_ms, CHART_COLUMNS, chart_columns);
+            drawChartSeries(current_series, chart_columns, 1.0f);
+            if (current_feed.extrema(now_ms, lo, hi)) {
+                scaleChartAxis(LV_CHART_AXIS_SECONDARY_Y, lo, hi, 1.0f, 10, current_axis);
+            }
+        } else {
+            // Longer windows from the history pyramid; redraw when it gains a bucket
+            size_t level = history.levelFor(window_ms, SIZE_MAX);
+            int64_t bucket = TimeSeriesPyramid::bucketIndex(level, now_ms);
+            if (bucket == chart_bucket) return;
+            TRACE_SCOPE("updateCurrentGraph");
+            chart_bucket = bucket;
+            
+            size_t points = std::min(window_ms / TimeSeriesPyramid::LEVEL_MS[level], chart_buckets.size());
+            float lo, hi;
+            history.read(HISTORY_VOLTAGE, level, now_ms, points, chart_buckets.data());
+            ChartFeed::decimateBuckets(chart_buckets.data(), points, CHART_COLUMNS, chart_columns);
+            drawChartSeries(voltage_series, chart_columns, VOLTAGE_CHART_SCALE);
+            if (chart_columns.range(lo, hi)) {
+                scaleChartAxis(LV_CHART_AXIS_PRIMARY_Y, lo, hi, VOLTAGE_CHART_SCALE, 10, voltage_axis);
+            }
+            
+            history.read(HISTORY_CURRENT, level, now_ms, points, chart_buckets.data());
+            ChartFeed::decimateBuckets(chart_buckets.data(), points, CHART_COLUMNS, chart_columns);
+            drawChartSeries(current_series, chart_columns, 1.0f);
+            if (chart_columns.range(lo, hi)) {
+                scaleChartAxis(LV_CHART_AXIS_SECONDARY_Y, lo, hi, 1.0f, 10, current_axis);
+            }
+        }
+        
+        lv_chart_refresh(objects.cht_pwusage);
+        chart_drawn_ms = now_ms;
+    }
+    
+    // Each pixel column becomes a min and a max point, so the line covers
+    // the full range of every column
+    void drawChartSeries(lv_chart_series_t* series, const ChartColumns& columns, float scale) {
+        int32_t* points = lv_chart_get_y_array(objects.cht_pwusage, series);
+        for (size_t i = 0; i < columns.count; i++) {
+            if (columns.has[i]) {
+                points[2 * i] = (int32_t)lrintf(columns.min[i] * scale);
+                points[2 * i + 1] = (int32_t)lrintf(columns.max[i] * scale);
+            } else {
+                points[2 * i] = points[2 * i + 1] = LV_CHART_POINT_NONE;
+            }
+        }
+        lv_chart_set_x_start_point(objects.cht_pwusage, series, 0);
+    }
+    
+    // Axis range rounded out to whole steps; only set when that changes
+    void scaleChartAxis(lv_chart_axis_t axis, float lo, float hi, float scale, int32_t step, ChartAxisRange& shown) {
+        int32_t min = (int32_t)floorf(lo * scale / step) * step;
+        int32_t max = (int32_t)ceilf(hi * scale / step) * step;
+        if (max <= min) max = min + step;
+        if (min == shown.min && max == shown.max) return;
+        
+        lv_chart_set_range(objects.cht_pwusage, axis, min, max);
+        shown.min = min;
+        shown.max = max;
     }
     
     void updateLightingStates() {
         if (startup_icons_active) return;
+        TRACE_SCOPE("updateLightingStates");
         
-        // Battery warning logic - ThunderSky Winston specific
-        bool battery_warning = false;
-        if (bms_connected && serial_comm->isBMSDataValid()) {
-            bool temp_high = (max_temp > 80.0);
-            bool temp_low = (min_temp < -30.0);
-            bool volt_high = (max_cell_voltage > 4.2 || max_cell_voltage > 4.0);
-            bool volt_low = (min_cell_voltage < 2.5 || min_cell_voltage < 2.8);
-            
-            battery_warning = temp_high || temp_low || volt_high || volt_low;
+        // Battery warning - severity comes from the alarm rules; the icon is
+        // only touched when it changes
+        AlarmSeverity alarm = isBMSLive() ? battery_alarms.getSeverity() : ALARM_NONE;
+        if (alarm != shown_alarm) {
+            if (alarm >= ALARM_WARNING) {
+                lv_obj_clear_flag(objects.img_icon_bat, LV_OBJ_FLAG_HIDDEN);
+            } else {
+                lv_obj_add_flag(objects.img_icon_bat, LV_OBJ_FLAG_HIDDEN);
+            }
+            lv_obj_set_style_image_recolor(objects.img_icon_bat, lv_color_hex(0xff0000), LV_PART_MAIN | LV_STATE_DEFAULT);
+            lv_obj_set_style_image_recolor_opa(objects.img_icon_bat, alarm == ALARM_CRITICAL ? LV_OPA_COVER : LV_OPA_TRANSP,
+                                               LV_PART_MAIN | LV_STATE_DEFAULT);
+            shown_alarm = alarm;
         }
         
-        // Update battery warning
-        if(battery_warning) {
-            lv_obj_clear_flag(objects.img_icon_bat, LV_OBJ_FLAG_HIDDEN);
-        } else {
-            lv_obj_add_flag(objects.img_icon_bat, LV_OBJ_FLAG_HIDDEN);
-        }
+        // Car overlays as one mask; only lamps that change are redrawn
+        uint8_t lamps = 0;
         
         // Reverse light
         bool reverse_should_be_on = reverse_light_on || (gear == 2);
         if(reverse_should_be_on) {
-            lv_obj_clear_flag(objects.img_reverselight, LV_OBJ_FLAG_HIDDEN);
-        } else {
-            lv_obj_add_flag(objects.img_reverselight, LV_OBJ_FLAG_HIDDEN);
+            lamps |= LAMP_REVERSE;
         }
         
         // Lighting hierarchy logic
@@ -419,57 +1132,48 @@ public:
         if (!any_light_active) {
             // DRL mode
             lv_obj_clear_flag(objects.img_icon_drl, LV_OBJ_FLAG_HIDDEN);
-            lv_obj_clear_flag(objects.img_drl, LV_OBJ_FLAG_HIDDEN);
+            lamps |= LAMP_DRL;
             lv_obj_add_flag(objects.img_icon_light, LV_OBJ_FLAG_HIDDEN);
             lv_obj_add_flag(objects.img_icon_lowbeam, LV_OBJ_FLAG_HIDDEN);
             lv_obj_add_flag(objects.img_icon_highbeam, LV_OBJ_FLAG_HIDDEN);
-            lv_obj_add_flag(objects.img_lowbeam, LV_OBJ_FLAG_HIDDEN);
-            lv_obj_add_flag(objects.img_highbeam, LV_OBJ_FLAG_HIDDEN);
         } else if (highbeam_on) {
             // High beam active
             lv_obj_clear_flag(objects.img_icon_highbeam, LV_OBJ_FLAG_HIDDEN);
-            lv_obj_clear_flag(objects.img_highbeam, LV_OBJ_FLAG_HIDDEN);
+            lamps |= LAMP_HIGHBEAM;
             lv_obj_add_flag(objects.img_icon_drl, LV_OBJ_FLAG_HIDDEN);
-            lv_obj_add_flag(objects.img_drl, LV_OBJ_FLAG_HIDDEN);
             lv_obj_add_flag(objects.img_icon_light, LV_OBJ_FLAG_HIDDEN);
             lv_obj_add_flag(objects.img_icon_lowbeam, LV_OBJ_FLAG_HIDDEN);
-            lv_obj_add_flag(objects.img_lowbeam, LV_OBJ_FLAG_HIDDEN);
         } else if (lowbeam_on) {
             // Low beam active
             lv_obj_clear_flag(objects.img_icon_lowbeam, LV_OBJ_FLAG_HIDDEN);
-            lv_obj_clear_flag(objects.img_lowbeam, LV_OBJ_FLAG_HIDDEN);
+            lamps |= LAMP_LOWBEAM;
             lv_obj_add_flag(objects.img_icon_drl, LV_OBJ_FLAG_HIDDEN);
-            lv_obj_add_flag(objects.img_drl, LV_OBJ_FLAG_HIDDEN);
             lv_obj_add_flag(objects.img_icon_light, LV_OBJ_FLAG_HIDDEN);
             lv_obj_add_flag(objects.img_icon_highbeam, LV_OBJ_FLAG_HIDDEN);
-            lv_obj_add_flag(objects.img_highbeam, LV_OBJ_FLAG_HIDDEN);
         } else if (light_on) {
             // Light ON mode
             lv_obj_clear_flag(objects.img_icon_light, LV_OBJ_FLAG_HIDDEN);
-            lv_obj_clear_flag(objects.img_lowbeam, LV_OBJ_FLAG_HIDDEN);
-            lv_obj_clear_flag(objects.img_drl, LV_OBJ_FLAG_HIDDEN);
+            lamps |= LAMP_LOWBEAM | LAMP_DRL;
             lv_obj_add_flag(objects.img_icon_drl, LV_OBJ_FLAG_HIDDEN);
             lv_obj_add_flag(objects.img_icon_lowbeam, LV_OBJ_FLAG_HIDDEN);
             lv_obj_add_flag(objects.img_icon_highbeam, LV_OBJ_FLAG_HIDDEN);
-            lv_obj_add_flag(objects.img_highbeam, LV_OBJ_FLAG_HIDDEN);
         }
         
         // Rear lights
         if(any_light_active) {
-            lv_obj_clear_flag(objects.img_rearlight, LV_OBJ_FLAG_HIDDEN);
-        } else {
-            lv_obj_add_flag(objects.img_rearlight, LV_OBJ_FLAG_HIDDEN);
+            lamps |= LAMP_REAR;
         }
         
         // Other lighting states
         if(fog_rear_on) {
             lv_obj_clear_flag(objects.img_icon_fog_rear, LV_OBJ_FLAG_HIDDEN);
-            lv_obj_clear_flag(objects.img_fogrear, LV_OBJ_FLAG_HIDDEN);
+            lamps |= LAMP_FOG_REAR;
         } else {
             lv_obj_add_flag(objects.img_icon_fog_rear, LV_OBJ_FLAG_HIDDEN);
-            lv_obj_add_flag(objects.img_fogrear, LV_OBJ_FLAG_HIDDEN);
         }
         
+        lighting.setLights(lamps);
+        
         if(handbrake_on) {
             lv_obj_clear_flag(objects.img_icon_park, LV_OBJ_FLAG_HIDDEN);
         } else {
@@ -544,34 +1248,106 @@ public:
     }
     
     void resetTrip() {
+        closeTrip();
         trip_km = 0.0;
+        energy.resetTrip();
         saveToStorage();
+        persistence.flush();
         std::cout << "Trip: Counter reset to 0.0 km" << std::endl;
     }
     
     void loadFromStorage() {
-        std::ifstream file("dashboard_data.txt");
-        if (file.is_open()) {
-            file >> odo_km >> trip_km;
-            file.close();
+        odometer_store.open();
+        
+        if (odometer_store.hasState()) {
+            const OdometerState& state = odometer_store.getState();
+            odo_km = state.odo_km;
+            trip_km = state.trip_km;
+            if (state.soc_valid) {
+                soc_percent = (int)state.soc_percent;
+                soc_known = true;
+            }
+            
+            EnergyTotals trip_energy, lifetime_energy;
+            trip_energy.used_wh = state.trip_used_kwh * 1000.0;
+            trip_energy.regen_wh = state.trip_regen_kwh * 1000.0;
+            lifetime_energy.used_wh = state.lifetime_used_kwh * 1000.0;
+            lifetime_energy.regen_wh = state.lifetime_regen_kwh * 1000.0;
+            energy.restore(trip_energy, lifetime_energy);
+            range.restoreLearned(state.learned_wh_per_km);
             std::cout << "Storage: Loaded ODO=" << odo_km << "km, TRIP=" << trip_km << "km" << std::endl;
+        } else if (loadLegacyStorage()) {
+            // One-time migration from the old text file into the journal
+            odometer_store.save(snapshotState());
+            std::cout << "Storage: Migrated dashboard_data.txt ODO=" << odo_km << "km, TRIP=" << trip_km << "km" << std::endl;
         } else {
-            odo_km = saved_odo;
-            trip_km = saved_trip;
             std::cout << "Storage: Using defaults ODO=" << odo_km << "km, TRIP=" << trip_km << "km" << std::endl;
         }
+        
+        persistence.start();
+        
+        std::string alarm_config = BatteryAlarms::defaultConfigPath();
+        if (!battery_alarms.loadFile(alarm_config)) {
+            std::cout << "Alarms: No usable " << alarm_config << ", using built-in " << battery_alarms.getChemistry() << " rules" << std::endl;
+        }
+        
+        if (trip_history.open()) {
+            TripSummary all = trip_history.aggregate(0, INT64_MAX);
+            if (all.trips > 0) {
+                std::cout << "Trips: " << all.trips << " trips, " << all.distance_km << "km, "
+                          << all.whPerKm() << "Wh/km average" << std::endl;
+            }
+        }
     }
     
-    void saveToStorage() {
-        std::ofstream file("dashboard_data.txt");
-        if (file.is_open()) {
-            file << odo_km << " " << trip_km;
-            file.close();
+    // Hand a finished trip to the persistence worker
+    void closeTrip() {
+        TripRecord record;
+        if (!current_trip.close(time(nullptr), record)) return;
+        
+        std::cout << "Trip: Closed after " << record.distance_km << "km" << std::endl;
+        persistence.post([this, record] {
+            trip_history.append(record);
+        });
+    }
+    
+    // Pre-journal format: "odo trip [soc]" in the working directory
+    bool loadLegacyStorage() {
+        std::ifstream file("dashboard_data.txt");
+        if (!file.is_open() || !(file >> odo_km >> trip_km)) {
+            return false;
         }
+        
+        int last_soc;
+        if (file >> last_soc) {
+            soc_percent = last_soc;
+            soc_known = true;
+        }
+        return true;
+    }
+    
+    OdometerState snapshotState() {
+        OdometerState state;
+        state.odo_km = odo_km;
+        state.trip_km = trip_km;
+        state.soc_percent = soc_percent;
+        state.soc_valid = soc_known;
+        state.trip_used_kwh = energy.getTrip().used_wh / 1000.0;
+        state.trip_regen_kwh = energy.getTrip().regen_wh / 1000.0;
+        state.lifetime_used_kwh = energy.getLifetime().used_wh / 1000.0;
+        state.lifetime_regen_kwh = energy.getLifetime().regen_wh / 1000.0;
+        state.learned_wh_per_km = range.getLearnedWhPerKm();
+        return state;
+    }
+    
+    // Non-blocking - the worker decides when the snapshot hits the SD card
+    void saveToStorage() {
+        TRACE_SCOPE("saveToStorage");
+        persistence.submit(snapshotState());
     }
     
     void run() {
-        while (running) {
+        while (running && !shutdown_signal) {
             auto current_time = std::chrono::steady_clock::now();
             
             // Handle startup sequence
@@ -580,70 +1356,142 @@ public:
                 startup_icons_active = false;
                 hideAllIcons();
                 std::cout << "Startup: Icon test complete" << std::endl;
+                
+                // Main screen fade-in is long finished - splash can go
+                if (splash_screen) {
+                    lv_obj_delete(splash_screen);
+                    splash_screen = nullptr;
+                }
             }
             
             // Process vehicle data
-            if (serial_comm) {
+            if (serial_ready) {
                 serial_comm->processData();
                 
                 // Reset speed if automotive data times out
                 if (!serial_comm->isAutomotiveDataValid()) {
                     speed_kmh = 0.0;
+                    conditioned.resetSpeed();
                 }
                 
                 // Update BMS connection status
+                bool bms_was_connected = bms_connected;
                 bms_connected = serial_comm->isBMSDataValid();
+                if (bms_was_connected && !bms_connected) {
+                    onBMSLost();
+                }
+                diagnostics_screen.setSerial(&serial_comm->getStats(), serial_comm->isAutomotiveDataValid(), bms_connected);
             }
             
+            updatePowerState(current_time);
+            const PowerProfile& profile = power.getProfile();
+            
             // CHANGED: Update simplified audio manager (lightweight)
-            if (audio_manager) {
-                audio_manager->update();
+            if (audio_ready) {
+                if (audio_initialized && !audio_controls_enabled) {
+                    enableAudioControls();
+                    audio_controls_enabled = true;
+                }
+                if (profile.audio_poll_ms) {
+                    audio_manager->setPollInterval(profile.audio_poll_ms);
+                    audio_manager->update();
+                }
             }
             
             // Update display at regular intervals
             auto update_elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(current_time - last_update).count();
-            if(update_elapsed >= UPDATE_INTERVAL) {
+            if(update_elapsed >= (long long)profile.update_ms) {
                 updateDisplay();
-                updateCurrentGraph();
                 
                 if (!startup_icons_active) {
                     updateLightingStates();
                 }
+                screens.tick(uptimeMs());
                 
                 // Update odometer (integration over time)
                 float time_delta_hours = update_elapsed / 3600000.0f;
                 float distance_delta = speed_kmh * time_delta_hours;
                 odo_km += distance_delta;
                 trip_km += distance_delta;
+                energy.addDistance(distance_delta);
+                range.update(energy, distance_delta, soc_percent, soc_known);
+                
+                if (current_trip.isActive()) {
+                    if (speed_kmh > 0.0f) {
+                        current_trip.addDistance(distance_delta, time_delta_hours);
+                    }
+                    
+                    // Ignition off - vehicle data stopped arriving
+                    auto silent_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        current_time - last_vehicle_data_time).count();
+                    if (silent_ms >= TRIP_IGNITION_OFF_TIMEOUT) {
+                        closeTrip();
+                    }
+                }
+                
+                // Worker coalesces these and writes on distance/time policy
+                saveToStorage();
                 
                 last_update = current_time;
             }
             
-            // Save data periodically
-            auto save_elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(current_time - last_odo_save).count();
-            if(save_elapsed >= ODO_SAVE_INTERVAL) {
-                if(abs(odo_km - saved_odo) >= 1.0 || abs(trip_km - saved_trip) >= 1.0) {
-                    saveToStorage();
-                    saved_odo = odo_km;
-                    saved_trip = trip_km;
-                }
-                last_odo_save = current_time;
-            }
+            updateCurrentGraph();
             
             // Handle LVGL and UI events
-            uint32_t sleep_time = lv_timer_handler();
+            uint32_t sleep_time;
+            {
+                TRACE_SCOPE("lv_timer_handler");
+                sleep_time = lv_timer_handler();
+            }
             ui_tick();
             
             handleUIEvents();
             
+            sampleLvglMemory(current_time);
+            loop_latency.observeSince(current_time);
+            
+#ifdef ENABLE_TRACING
+            if (Trace::takeDumpRequest()) {
+                Trace::dumpChromeJson("trace_" + std::to_string(msSinceProcessStart()) + ".json");
+            }
+#endif
+            
             // Sleep
-            std::this_thread::sleep_for(std::chrono::milliseconds(sleep_time > 0 ? sleep_time : 5));
+            if (power.getState() == POWER_STANDBY && serial_ready) {
+                // Nothing renders; the next vehicle frame ends the wait, SDL
+                // events (close, waking tap) are drained between waits
+                serial_comm->waitForData(STANDBY_WAIT);
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(sleep_time > 0 ? std::min<uint32_t>(sleep_time, STANDBY_WAIT) : 5));
+            }
         }
     }
     
     void stop() {
         running = false;
         
+        if (shutdown_signal) {
+            std::cout << "Shutdown: Signal " << shutdown_signal << " received" << std::endl;
+        }
+        
+        // Final flush - never lose distance on a normal shutdown
+        closeTrip();
+        saveToStorage();
+        persistence.stop();
+        
+#ifdef ENABLE_TELEMETRY_LOG
+        telemetry.stop();
+#endif
+        
+        if (metrics) {
+            metrics->stop();
+        }
+        
+        // Audio init may still be waiting on the DSP
+        if (component_init_thread.joinable()) {
+            component_init_thread.join();
+        }
+        
         if (audio_manager) {
             audio_manager->shutdown();
         }
@@ -657,6 +1505,16 @@ public:
 int main() {
     std::cout << "=== LVGL Dashboard with BeoCreate 4 + Simple Bluetooth ===" << std::endl;
     
+    // Normal shutdown (systemd stop, UPS power-fail, Ctrl+C) goes through stop()
+    struct sigaction action = {};
+    action.sa_handler = onShutdownSignal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGTERM, &action, nullptr);
+    sigaction(SIGINT, &action, nullptr);
+#ifdef SIGPWR
+    sigaction(SIGPWR, &action, nullptr);
+#endif
+    
     Dashboard dashboard;
     
     try {
@@ -664,6 +1522,7 @@ int main() {
         dashboard.run();
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
+        dashboard.stop();
         return 1;
     }
     
@@ -0,0 +1,41 @@
+#!/bin/bash
+# bench_render_modes.sh - run the render benchmark in every buffering mode
+#
+#   tools/bench_render_modes.sh ./build/LVGLDashboard_deployment [frames]
+#
+# Render mode, buffer lines and buffer count are switched through the
+# environment (see SdlDisplay.h). Draw units are a build option, so build
+# once per -DLVGL_DRAW_UNITS=1/2/3 and run this against each binary.
+# Prints one line per combination and scene, sorted by p99 frame time.
+
+set -e
+
+BINARY=${1:?usage: $0 BINARY [frames]}
+FRAMES=${2:-300}
+
+run() {
+    local label="$1"
+    shift
+    env "$@" TAZZARI_RENDER_BENCH="$FRAMES" "$BINARY" 2>/dev/null |
+        awk -v label="$label" '
+            /^RenderBenchmark:/ { table = 1; next }
+            table && $1 == "scene" { next }
+            table && NF >= 7 && $NF ~ /^[0-9.]+$/ {
+                # Scene names may contain spaces: the last six fields are numbers
+                name = $1
+                for (i = 2; i <= NF - 6; i++) name = name "_" $i
+                printf "%-28s %-16s %s\n", label, name, $(NF - 3)
+            }'
+}
+
+{
+    for count in 1 2; do
+        for lines in 30 60 120 300; do
+            run "partial/${lines}l/x${count}" TAZZARI_RENDER_MODE=partial TAZZARI_DRAW_BUF_LINES=$lines TAZZARI_DRAW_BUF_COUNT=$count
+        done
+        run "direct/x${count}" TAZZARI_RENDER_MODE=direct TAZZARI_DRAW_BUF_COUNT=$count
+        run "full/x${count}" TAZZARI_RENDER_MODE=full TAZZARI_DRAW_BUF_COUNT=$count
+    done
+} | sort -k2,2 -k3,3n | awk '
+    BEGIN { printf "%-28s %-16s %s\n", "config", "scene", "p99 ms" }
+    { print }'
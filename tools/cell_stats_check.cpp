@@ -0,0 +1,113 @@
+// cell-stats-check - compares the compiled CellStats kernel (NEON, SSE2 or
+// scalar) with a plain reference, including out-of-range readings.
+//
+//   cell-stats-check [frames]
+//
+// Exits non-zero on the first mismatch.
+#include "CellStats.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+// Straightforward reference: readings above MAX_CELL_MV are left out
+static CellStatistics reference(const uint16_t* cell_mv, size_t count) {
+    CellStatistics out;
+    out.cell_count = (int)count;
+    uint64_t sum = 0, sum_squares = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint16_t mv = cell_mv[i];
+        if (mv > CellStats::MAX_CELL_MV) {
+            out.invalid_count++;
+            continue;
+        }
+        if (out.valid_count == 0 || mv < out.min_mv) { out.min_mv = mv; out.min_index = (int)i; }
+        if (out.valid_count == 0 || mv > out.max_mv) { out.max_mv = mv; out.max_index = (int)i; }
+        sum += mv;
+        sum_squares += (uint64_t)mv * mv;
+        out.valid_count++;
+    }
+    if (out.valid_count > 0) {
+        double mean = (double)sum / out.valid_count;
+        double variance = (double)sum_squares / out.valid_count - mean * mean;
+        out.mean_mv = (float)mean;
+        out.imbalance_mv = (float)std::sqrt(std::max(0.0, variance));
+        out.spread_mv = out.max_mv - out.min_mv;
+    }
+    return out;
+}
+
+static bool check(const char* what, const uint16_t* cell_mv, size_t count) {
+    CellStatistics got;
+    CellStats::computeVoltages(cell_mv, count, got);
+    CellStatistics want = reference(cell_mv, count);
+
+    bool ok = got.cell_count == want.cell_count && got.valid_count == want.valid_count &&
+              got.invalid_count == want.invalid_count && got.min_index == want.min_index &&
+              got.max_index == want.max_index;
+    if (ok && want.valid_count > 0) {
+        ok = got.min_mv == want.min_mv && got.max_mv == want.max_mv && got.spread_mv == want.spread_mv &&
+             got.mean_mv == want.mean_mv && got.imbalance_mv == want.imbalance_mv;
+    }
+    if (!ok) {
+        fprintf(stderr, "FAIL %s (%zu cells): valid %d/%d invalid %d/%d min %u#%d/%u#%d max %u#%d/%u#%d "
+                "mean %.3f/%.3f sd %.3f/%.3f (got/want)\n",
+                what, count, got.valid_count, want.valid_count, got.invalid_count, want.invalid_count,
+                got.min_mv, got.min_index, want.min_mv, want.min_index,
+                got.max_mv, got.max_index, want.max_mv, want.max_index,
+                got.mean_mv, want.mean_mv, got.imbalance_mv, want.imbalance_mv);
+    }
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? std::max(1, atoi(argv[1])) : 20000;
+    printf("kernel: %s\n", CellStats::kernelName());
+
+    uint16_t cells[MAX_CELLS];
+
+    // One faulted sensor at every position of a full pack: excluded, and
+    // the extremes still resolve to a real cell
+    for (size_t bad = 0; bad < MAX_CELLS; bad++) {
+        for (size_t i = 0; i < MAX_CELLS; i++) cells[i] = (uint16_t)(3300 + (i * 7) % 40);
+        cells[bad] = 0xFFFF;
+        if (!check("one 0xFFFF cell", cells, MAX_CELLS)) return 1;
+
+        CellStatistics stats;
+        CellStats::computeVoltages(cells, MAX_CELLS, stats);
+        if (stats.max_index < 0 || stats.max_mv > 3400 || stats.invalid_count != 1) {
+            fprintf(stderr, "FAIL faulted cell %zu leaked into the statistics\n", bad);
+            return 1;
+        }
+    }
+
+    // Just inside and just outside the limit
+    for (size_t i = 0; i < 16; i++) cells[i] = 3300;
+    cells[3] = CellStats::MAX_CELL_MV;
+    cells[11] = CellStats::MAX_CELL_MV + 1;
+    if (!check("limit", cells, 16)) return 1;
+
+    // No valid reading at all
+    for (size_t i = 0; i < 24; i++) cells[i] = 0xFFFF;
+    if (!check("all faulted", cells, 24)) return 1;
+    if (!check("empty", cells, 0)) return 1;
+
+    // Random frames: healthy packs, packs with a few faults, and full-range noise
+    std::mt19937 rng(1);
+    for (int frame = 0; frame < frames; frame++) {
+        size_t count = rng() % (MAX_CELLS + 1);
+        for (size_t i = 0; i < count; i++) {
+            switch (frame % 3) {
+                case 0: cells[i] = (uint16_t)(2500 + rng() % 1200); break;
+                case 1: cells[i] = rng() % 10 == 0 ? (uint16_t)(CellStats::MAX_CELL_MV + 1 + rng() % 50000)
+                                                   : (uint16_t)(2500 + rng() % 1200); break;
+                default: cells[i] = (uint16_t)rng(); break;
+            }
+        }
+        if (!check("random", cells, count)) return 1;
+    }
+
+    printf("OK (%d random frames)\n", frames);
+    return 0;
+}
@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+"""Re-encode an EEZ Studio image (ui/ui_image_*.c, ARGB8888) into a compact
+LVGL v9 colour format.
+
+    convert_ui_image.py ui/ui_image_drl.c build/ui_images/ui_image_drl.c
+    convert_ui_image.py --report ui/ui_image_*.c
+
+Every image gets a format LVGL blends straight from the const data, so no
+decoded copy is ever allocated: RGB565 when every pixel is opaque, RGB565A8
+otherwise (3 bytes per pixel instead of 4).
+
+I4 / I8 are still available through FORMAT_OVERRIDES, but LVGL v9.0 decodes
+indexed images to ARGB8888 on the LVGL heap (LV_MEM_SIZE in lv_conf.h) -
+for the icons here that is ~254 KB of heap to save ~97 KB of flash.
+
+The generated file keeps the symbol names, so ui/images.c and screens.c
+link against it unchanged.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+# Per-image overrides by descriptor name: "I4", "I8", "RGB565", "RGB565A8", "ARGB8888"
+FORMAT_OVERRIDES = {
+}
+
+LV_FORMATS = {
+    "I4": "LV_COLOR_FORMAT_I4",
+    "I8": "LV_COLOR_FORMAT_I8",
+    "RGB565": "LV_COLOR_FORMAT_RGB565",
+    "RGB565A8": "LV_COLOR_FORMAT_RGB565A8",
+    "ARGB8888": "LV_COLOR_FORMAT_ARGB8888",
+}
+
+
+class Image:
+    def __init__(self, path):
+        self.path = path
+        text = open(path).read()
+
+        # "static const <attributes> uint8_t name_map[] = {", possibly over several lines
+        map_match = re.search(r"(?:static\s+)?const\s[^;{]*?uint8_t\s+(\w+)_map\[\]\s*=\s*\{", text)
+        if not map_match:
+            raise ValueError(f"{path}: no image map")
+        self.name = map_match.group(1)
+        self.preamble = text[:map_match.start()]
+        self.declaration = map_match.group(0)
+
+        body_end = text.index("};", map_match.end())
+        body = text[map_match.end():body_end]
+        self.data = bytes(int(b, 16) for b in re.findall(r"0x([0-9a-fA-F]{2})", body))
+
+        def header(field):
+            m = re.search(r"\.header\." + field + r"\s*=\s*(\w+)", text)
+            if not m:
+                raise ValueError(f"{path}: no header.{field}")
+            return m.group(1)
+
+        self.cf = header("cf")
+        self.width = int(header("w"))
+        self.height = int(header("h"))
+        self.stride = int(header("stride"))
+        if self.cf != "LV_COLOR_FORMAT_ARGB8888":
+            raise ValueError(f"{path}: expected ARGB8888, got {self.cf}")
+
+    def pixels(self):
+        """(b, g, r, a) tuples, row by row"""
+        for y in range(self.height):
+            row = y * self.stride
+            for x in range(self.width):
+                yield tuple(self.data[row + x * 4:row + x * 4 + 4])
+
+
+def choose_format(image, pixels):
+    if image.name in FORMAT_OVERRIDES:
+        return FORMAT_OVERRIDES[image.name]
+    if all(p[3] == 255 for p in pixels):
+        return "RGB565"
+    return "RGB565A8"
+
+
+def rgb565(p):
+    b, g, r = p[0], p[1], p[2]
+    value = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3)
+    return bytes((value & 0xFF, value >> 8))
+
+
+def encode(image, pixels, fmt):
+    """Returns (data, stride)"""
+    w, h = image.width, image.height
+
+    if fmt == "ARGB8888":
+        return b"".join(bytes(p) for p in pixels), w * 4
+
+    if fmt in ("I4", "I8"):
+        palette = sorted(set(pixels))
+        size = 16 if fmt == "I4" else 256
+        if len(palette) > size:
+            raise ValueError(f"{image.name}: {len(palette)} colours do not fit {fmt}")
+        index = {p: i for i, p in enumerate(palette)}
+        out = bytearray()
+        for p in palette + [(0, 0, 0, 0)] * (size - len(palette)):
+            out += bytes(p)
+        if fmt == "I8":
+            stride = w
+            out += bytes(index[p] for p in pixels)
+        else:
+            # Two pixels per byte, first pixel in the high nibble
+            stride = (w + 1) // 2
+            for y in range(h):
+                row = [index[p] for p in pixels[y * w:(y + 1) * w]] + [0]
+                for x in range(0, w, 2):
+                    out.append((row[x] << 4) | row[x + 1])
+        return bytes(out), stride
+
+    if fmt == "RGB565":
+        return b"".join(rgb565(p) for p in pixels), w * 2
+
+    if fmt == "RGB565A8":
+        # RGB565 plane followed by the alpha plane
+        colour = b"".join(rgb565(p) for p in pixels)
+        alpha = bytes(p[3] for p in pixels)
+        return colour + alpha, w * 2
+
+    raise ValueError(f"unknown format {fmt}")
+
+
+def write_c(image, fmt, data, stride, path):
+    lines = [image.preamble, image.declaration, "\n"]
+    for i in range(0, len(data), 32):
+        lines.append("    " + ",".join(f"0x{b:02x}" for b in data[i:i + 32]) + ",\n")
+    lines.append("};\n\n")
+    lines.append(f"const lv_img_dsc_t {image.name} = {{\n"
+                 f"  .header.magic = LV_IMAGE_HEADER_MAGIC,\n"
+                 f"  .header.cf = {LV_FORMATS[fmt]},\n"
+                 f"  .header.flags = 0,\n"
+                 f"  .header.w = {image.width},\n"
+                 f"  .header.h = {image.height},\n"
+                 f"  .header.stride = {stride},\n"
+                 f"  .data_size = {len(data)},\n"
+                 f"  .data = {image.name}_map,\n"
+                 f"}};\n")
+
+    os.makedirs(os.path.dirname(os.path.abspath(path)), exist_ok=True)
+    tmp = path + ".tmp"
+    with open(tmp, "w") as f:
+        f.write("".join(lines))
+    os.replace(tmp, path)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("files", nargs="+", metavar="INPUT [OUTPUT]")
+    parser.add_argument("--report", action="store_true", help="print the chosen formats and sizes only")
+    args = parser.parse_args()
+
+    inputs = args.files if args.report else args.files[:-1]
+    output = None if args.report else args.files[-1]
+    if not args.report and len(inputs) != 1:
+        parser.error("convert one image at a time: INPUT OUTPUT")
+
+    total_before = total_after = 0
+    for path in inputs:
+        image = Image(path)
+        pixels = list(image.pixels())
+        fmt = choose_format(image, pixels)
+        data, stride = encode(image, pixels, fmt)
+        total_before += len(image.data)
+        total_after += len(data)
+
+        if args.report:
+            print(f"{image.name:32s} {image.width:4d}x{image.height:<4d} {len(image.data):8d} -> {len(data):8d}  {fmt}")
+        else:
+            write_c(image, fmt, data, stride, output)
+
+    if args.report:
+        print(f"{'total':42s} {total_before:8d} -> {total_after:8d}  ({100.0 * total_after / total_before:.0f}%)")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
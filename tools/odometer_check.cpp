@@ -0,0 +1,288 @@
+// odometer-check - fault injection and benchmark for the ODO/trip/SOC journal.
+//
+//   odometer-check faults [dir]          truncate / tear the journal at every byte
+//   odometer-check bench [-n saves] [dir]
+//
+// Runs the dashboard's OdometerStore against a scratch journal in `dir`
+// (default: a new directory under $TMPDIR). Run bench on the SD card itself
+// for representative numbers; tmpfs shows the software cost only.
+#include "OdometerStore.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Saves for the fault run: wraps the 64-slot ring once so every slot holds a record
+static const int FAULT_SAVES = OdometerStore::SLOT_COUNT + 6;
+
+// Distinct, exactly representable state for each sequence number
+static OdometerState stateFor(uint64_t sequence) {
+    OdometerState state;
+    state.odo_km = sequence * 1.5;
+    state.trip_km = sequence * 0.25;
+    state.soc_percent = (float)(sequence % 100);
+    state.soc_valid = true;
+    state.learned_wh_per_km = (float)sequence;
+    return state;
+}
+
+static bool sameState(const OdometerState& a, const OdometerState& b) {
+    return a.odo_km == b.odo_km && a.trip_km == b.trip_km &&
+           a.soc_percent == b.soc_percent && a.soc_valid == b.soc_valid &&
+           a.learned_wh_per_km == b.learned_wh_per_km;
+}
+
+// OdometerStore logs every open; keep the fault loop quiet
+class QuietStdout {
+public:
+    QuietStdout() : saved(std::cout.rdbuf(sink.rdbuf())) {}
+    ~QuietStdout() { std::cout.rdbuf(saved); }
+
+private:
+    std::ostringstream sink;
+    std::streambuf* saved;
+};
+
+static bool readFile(const std::string& path, std::vector<uint8_t>& data) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    data.assign(OdometerStore::FILE_SIZE, 0);
+    ssize_t length = pread(fd, data.data(), data.size(), 0);
+    close(fd);
+    if (length < 0) return false;
+    data.resize(length);
+    return true;
+}
+
+static bool writeFile(const std::string& path, const uint8_t* data, size_t length) {
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    bool ok = length == 0 || write(fd, data, length) == (ssize_t)length;
+    close(fd);
+    return ok;
+}
+
+// Sequence a fresh open() must recover from `data`: the newest record whose
+// slot survived intact, 0 if none did. Slot s holds the last sequence
+// written to it, i.e. the largest sequence <= newest with sequence % SLOT_COUNT == s.
+static uint64_t expectedSequence(uint64_t newest, size_t intact_bytes) {
+    uint64_t best = 0;
+    for (int slot = 0; slot < OdometerStore::SLOT_COUNT; slot++) {
+        size_t end = (size_t)slot * OdometerStore::SLOT_SIZE + sizeof(OdometerRecord);
+        if (end > intact_bytes) continue;
+        uint64_t sequence = newest - ((newest - slot) % OdometerStore::SLOT_COUNT);
+        if (sequence >= 1 && sequence <= newest) best = std::max(best, sequence);
+    }
+    return best;
+}
+
+// Open `path` and compare the recovered state with `expected` (0 = no state)
+static bool checkRecovery(const std::string& path, uint64_t expected, const char* what, size_t offset) {
+    OdometerStore store(path);
+    bool opened;
+    {
+        QuietStdout quiet;
+        opened = store.open();
+    }
+    bool ok = opened && (expected == 0
+        ? !store.hasState()
+        : store.hasState() && sameState(store.getState(), stateFor(expected)));
+    if (!ok) {
+        fprintf(stderr, "FAIL %s at byte %zu: expected %s #%llu, recovered %s\n", what, offset,
+                expected ? "record" : "no record", (unsigned long long)expected,
+                !opened ? "open failure" : store.hasState() ? "a different record" : "nothing");
+    }
+    return ok;
+}
+
+static int runFaults(const std::string& dir) {
+    std::string path = dir + "/odometer.jrnl";
+    unlink(path.c_str());
+
+    std::vector<uint8_t> before, after;
+    {
+        QuietStdout quiet;
+        OdometerStore store(path);
+        if (!store.open()) return 1;
+        for (int i = 1; i <= FAULT_SAVES; i++) {
+            if (i == FAULT_SAVES && !readFile(path, before)) return 1;
+            if (!store.save(stateFor(i))) return 1;
+        }
+    }
+    if (!readFile(path, after) || after.size() != OdometerStore::FILE_SIZE) return 1;
+
+    int failures = 0;
+
+    // Truncation at every byte: recovery must return the newest record that
+    // is still complete, never a torn or older one
+    for (size_t length = 0; length <= after.size(); length++) {
+        if (!writeFile(path, after.data(), length)) return 1;
+        if (!checkRecovery(path, expectedSequence(FAULT_SAVES, length), "truncate", length)) failures++;
+    }
+    printf("truncate: %zu offsets checked\n", after.size() + 1);
+
+    // Torn final save: only the first `torn` bytes of its slot reached the
+    // disk. Anything short of the whole record must fall back to the
+    // previous one, and the next save must still win after recovery.
+    size_t slot_offset = (size_t)(FAULT_SAVES % OdometerStore::SLOT_COUNT) * OdometerStore::SLOT_SIZE;
+    for (size_t torn = 0; torn <= OdometerStore::SLOT_SIZE; torn++) {
+        std::vector<uint8_t> image = before;
+        memcpy(image.data() + slot_offset, after.data() + slot_offset, torn);
+        if (!writeFile(path, image.data(), image.size())) return 1;
+
+        uint64_t expected = torn >= sizeof(OdometerRecord) ? FAULT_SAVES : FAULT_SAVES - 1;
+        if (!checkRecovery(path, expected, "torn write", torn)) {
+            failures++;
+            continue;
+        }
+
+        {
+            QuietStdout quiet;
+            OdometerStore store(path);
+            if (!store.open() || !store.save(stateFor(FAULT_SAVES + 1))) return 1;
+        }
+        if (!checkRecovery(path, FAULT_SAVES + 1, "save after torn write", torn)) failures++;
+    }
+    printf("torn write: %zu prefixes checked\n", OdometerStore::SLOT_SIZE + 1);
+
+    unlink(path.c_str());
+    printf("%s (%d failures)\n", failures ? "FAIL" : "OK", failures);
+    return failures ? 1 : 0;
+}
+
+// Bytes this process caused to be sent to storage; 0 on tmpfs or without /proc
+static uint64_t processWriteBytes() {
+    FILE* file = fopen("/proc/self/io", "r");
+    if (!file) return 0;
+    char line[128];
+    unsigned long long bytes = 0;
+    while (fgets(line, sizeof(line), file)) {
+        if (sscanf(line, "write_bytes: %llu", &bytes) == 1) break;
+    }
+    fclose(file);
+    return bytes;
+}
+
+static double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    return values[(size_t)(p * (values.size() - 1))];
+}
+
+static int runBench(const std::string& dir, int saves) {
+    std::string path = dir + "/odometer.jrnl";
+    unlink(path.c_str());
+
+    std::vector<double> save_us;
+    uint64_t store_bytes = 0;
+    uint64_t device_before = processWriteBytes();
+    {
+        QuietStdout quiet;
+        OdometerStore store(path);
+        if (!store.open()) return 1;
+        for (int i = 1; i <= saves; i++) {
+            auto start = std::chrono::steady_clock::now();
+            if (!store.save(stateFor(i))) return 1;
+            save_us.push_back(std::chrono::duration<double, std::micro>(
+                std::chrono::steady_clock::now() - start).count());
+        }
+        store_bytes = store.getBytesWritten();
+    }
+    uint64_t device_bytes = processWriteBytes() - device_before;
+
+    const int OPENS = 200;
+    std::vector<double> recovery_us;
+    for (int i = 0; i < OPENS; i++) {
+        QuietStdout quiet;
+        OdometerStore store(path);
+        if (!store.open() || !store.hasState()) return 1;
+        recovery_us.push_back((double)store.getRecoveryTimeUs());
+    }
+
+    double payload = (double)saves * sizeof(OdometerRecord);
+    printf("saves:            %d\n", saves);
+    printf("save latency:     p50 %.0f us  p99 %.0f us\n", percentile(save_us, 0.5), percentile(save_us, 0.99));
+    printf("bytes per save:   %.0f (record %zu)\n", (double)store_bytes / saves, sizeof(OdometerRecord));
+    printf("write amp. (app): %.1fx\n", store_bytes / payload);
+    if (device_bytes) {
+        printf("write amp. (dev): %.1fx  (%llu bytes incl. metadata)\n",
+               device_bytes / payload, (unsigned long long)device_bytes);
+    } else {
+        printf("write amp. (dev): n/a (no block-device writes seen; tmpfs?)\n");
+    }
+    printf("writes per slot:  %.1f over %d slots\n", (double)saves / OdometerStore::SLOT_COUNT,
+           OdometerStore::SLOT_COUNT);
+    printf("recovery:         p50 %.0f us  p99 %.0f us (%d opens)\n",
+           percentile(recovery_us, 0.5), percentile(recovery_us, 0.99), OPENS);
+
+    unlink(path.c_str());
+    return 0;
+}
+
+static void usage() {
+    fprintf(stderr,
+        "usage: odometer-check faults [dir]\n"
+        "       odometer-check bench [-n saves] [dir]\n"
+        "\n"
+        "faults  truncate the journal at every byte and tear the newest record at\n"
+        "        every prefix; exits non-zero if recovery returns anything but the\n"
+        "        newest complete record\n"
+        "bench   save latency, write amplification and recovery time\n"
+        "\n"
+        "dir defaults to a new scratch directory under $TMPDIR (removed afterwards).\n");
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage();
+        return 2;
+    }
+    std::string command = argv[1];
+    int saves = 1000;
+    std::string dir;
+
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-n" && i + 1 < argc) {
+            saves = std::max(1, atoi(argv[++i]));
+        } else if (arg == "-h" || arg == "--help") {
+            usage();
+            return 0;
+        } else {
+            dir = arg;
+        }
+    }
+
+    bool scratch = dir.empty();
+    if (scratch) {
+        const char* tmp = getenv("TMPDIR");
+        std::string pattern = std::string(tmp ? tmp : "/tmp") + "/odometer-check.XXXXXX";
+        std::vector<char> buffer(pattern.begin(), pattern.end());
+        buffer.push_back('\0');
+        if (!mkdtemp(buffer.data())) {
+            perror("mkdtemp");
+            return 1;
+        }
+        dir = buffer.data();
+    }
+
+    int result;
+    if (command == "faults") {
+        result = runFaults(dir);
+    } else if (command == "bench") {
+        result = runBench(dir, saves);
+    } else {
+        usage();
+        result = 2;
+    }
+
+    if (scratch) rmdir(dir.c_str());
+    return result;
+}
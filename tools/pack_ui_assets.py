@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+"""Pack the EEZ Studio images (ui/ui_image_*.c) into one memory-mapped asset
+file for the ASSET_PACK build.
+
+    pack_ui_assets.py tazzari.assets ui/ui_image_*.c
+    pack_ui_assets.py --stubs ui_image_stubs.c tazzari.assets ui/ui_image_*.c
+
+The dashboard maps the pack read-only and draws straight from the mapping
+(AssetPack.cpp), so every image is stored in a format LVGL blends without a
+decode step - RGB565 when opaque, RGB565A8 otherwise - and starts on its own
+4 KB page: an image's pages are only read from disk when it is first drawn.
+
+--stubs also writes the lv_img_dsc_t symbols ui/screens.c links against.
+They carry the image name instead of pixels and are resolved through the
+pack at runtime, so new artwork with the same names ships by replacing the
+pack file alone - no rebuild.
+
+Layout (little endian):
+    header  64 bytes   magic "TZAP", u16 version, u16 entry count,
+                       u32 index offset
+    index   64 bytes per entry: char name[40], u8 kind (0 = image),
+                       u8 format (1 = RGB565, 2 = RGB565A8, 3 = ARGB8888),
+                       u16 w, u16 h, u16 stride, u32 offset, u32 size
+    data    page aligned
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+from convert_ui_image import Image, encode
+
+PACK_MAGIC = 0x50415A54   # "TZAP"
+PACK_VERSION = 1
+HEADER_SIZE = 64
+ENTRY_SIZE = 64
+NAME_SIZE = 40
+PAGE_SIZE = 4096
+
+KIND_IMAGE = 0
+PACK_FORMATS = {"RGB565": 1, "RGB565A8": 2, "ARGB8888": 3}
+LV_FORMATS = {"RGB565": "LV_COLOR_FORMAT_RGB565", "RGB565A8": "LV_COLOR_FORMAT_RGB565A8",
+              "ARGB8888": "LV_COLOR_FORMAT_ARGB8888"}
+
+
+def drawable_format(pixels):
+    return "RGB565" if all(p[3] == 255 for p in pixels) else "RGB565A8"
+
+
+def align(value, to):
+    return (value + to - 1) // to * to
+
+
+def write_atomic(path, data, mode):
+    os.makedirs(os.path.dirname(os.path.abspath(path)), exist_ok=True)
+    tmp = path + ".tmp"
+    with open(tmp, mode) as f:
+        f.write(data)
+    os.replace(tmp, path)
+
+
+def build_pack(images):
+    """images: (Image, format, data, stride) tuples -> pack bytes"""
+    index = bytearray()
+    blobs = bytearray()
+    data_start = align(HEADER_SIZE + ENTRY_SIZE * len(images), PAGE_SIZE)
+
+    for image, fmt, data, stride in images:
+        name = image.name.encode()
+        if len(name) >= NAME_SIZE:
+            raise ValueError(f"{image.name}: name longer than {NAME_SIZE - 1} bytes")
+        offset = data_start + len(blobs)
+        index += struct.pack("<40sBBHHHII", name, KIND_IMAGE, PACK_FORMATS[fmt],
+                             image.width, image.height, stride, offset, len(data))
+        index += bytes(ENTRY_SIZE - struct.calcsize("<40sBBHHHII"))
+        blobs += data
+        blobs += bytes(align(len(blobs), PAGE_SIZE) - len(blobs))
+
+    header = struct.pack("<IHHI", PACK_MAGIC, PACK_VERSION, len(images), HEADER_SIZE)
+    header += bytes(HEADER_SIZE - len(header))
+    out = header + index
+    return out + bytes(data_start - len(out)) + blobs
+
+
+def build_stubs(images):
+    lines = ["// Generated by tools/pack_ui_assets.py - pixels live in the asset pack\n",
+             "#include <lvgl.h>\n\n"]
+    for image, fmt, data, stride in images:
+        lines.append(f"const lv_img_dsc_t {image.name} = {{\n"
+                     f"  .header.magic = LV_IMAGE_HEADER_MAGIC,\n"
+                     f"  .header.cf = {LV_FORMATS[fmt]},\n"
+                     f"  .header.flags = LV_IMAGE_FLAGS_USER1,\n"
+                     f"  .header.w = {image.width},\n"
+                     f"  .header.h = {image.height},\n"
+                     f"  .header.stride = {stride},\n"
+                     f"  .data_size = sizeof(\"{image.name}\"),\n"
+                     f"  .data = (const uint8_t *)\"{image.name}\",\n"
+                     f"}};\n\n")
+    return "".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("pack", metavar="PACK")
+    parser.add_argument("images", nargs="+", metavar="IMAGE")
+    parser.add_argument("--stubs", metavar="C_FILE", help="also write the descriptor stubs")
+    args = parser.parse_args()
+
+    images = []
+    for path in sorted(args.images):
+        image = Image(path)
+        pixels = list(image.pixels())
+        fmt = drawable_format(pixels)
+        data, stride = encode(image, pixels, fmt)
+        images.append((image, fmt, data, stride))
+
+    pack = build_pack(images)
+    write_atomic(args.pack, pack, "wb")
+    if args.stubs:
+        write_atomic(args.stubs, build_stubs(images), "w")
+
+    print(f"{args.pack}: {len(images)} images, {len(pack)} bytes")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
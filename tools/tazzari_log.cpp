@@ -0,0 +1,857 @@
+// tazzari-log - query and export dashboard telemetry logs off the car.
+//
+// Memory-maps .tzl telemetry logs (and raw serial captures), decodes
+// chunks in parallel with the same TelemetryFormat/PacketDecoder code the
+// dashboard runs, and merges the per-chunk results in time order.
+#include "TelemetryFormat.h"
+#include "PacketDecoder.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Samples further apart than this are not integrated across (link dropout,
+// ignition off, file boundary)
+static const int64_t MAX_GAP_MS = 5000;
+
+// ---- Fields ----
+
+enum Field {
+    FIELD_SOC, FIELD_CURRENT, FIELD_VOLTAGE, FIELD_POWER,
+    FIELD_MIN_CELL, FIELD_MAX_CELL, FIELD_CELL_DELTA, FIELD_MIN_TEMP, FIELD_MAX_TEMP,
+    FIELD_SPEED, FIELD_RPM,
+    FIELD_COUNT
+};
+
+static const char* FIELD_NAMES[FIELD_COUNT] = {
+    "soc", "current", "voltage", "power_kw",
+    "min_cell", "max_cell", "cell_delta", "min_temp", "max_temp",
+    "speed", "rpm",
+};
+
+static bool parseField(const char* name, Field& field) {
+    for (int f = 0; f < FIELD_COUNT; f++) {
+        if (strcmp(name, FIELD_NAMES[f]) == 0) {
+            field = (Field)f;
+            return true;
+        }
+    }
+    return false;
+}
+
+// False if this sample type doesn't carry the field
+static bool fieldValue(const TelemetrySample& sample, Field field, double& value) {
+    if (sample.type == TELEMETRY_AUTOMOTIVE) {
+        switch (field) {
+            case FIELD_SPEED: value = sample.automotive.speed_kmh; return true;
+            case FIELD_RPM:   value = sample.automotive.rpm; return true;
+            default: return false;
+        }
+    }
+
+    const bms_data_t& bms = sample.bms;
+    if (!bms.dataValid) return false;
+    switch (field) {
+        case FIELD_SOC:        value = bms.soc; return true;
+        case FIELD_CURRENT:    value = bms.current; return true;
+        case FIELD_VOLTAGE:    value = bms.totalVoltage; return true;
+        case FIELD_POWER:      value = bms.totalVoltage * bms.current / 1000.0; return true;
+        case FIELD_MIN_CELL:   value = bms.minVoltage; return true;
+        case FIELD_MAX_CELL:   value = bms.maxVoltage; return true;
+        case FIELD_CELL_DELTA: value = bms.maxVoltage - bms.minVoltage; return true;
+        case FIELD_MIN_TEMP:   value = bms.minTemp; return true;
+        case FIELD_MAX_TEMP:   value = bms.maxTemp; return true;
+        default: return false;
+    }
+}
+
+// ---- Query description ----
+
+enum QueryKind { QUERY_SUMMARY, QUERY_WHERE, QUERY_ENERGY_PER_DAY, QUERY_DOWNSAMPLE, QUERY_EXPORT };
+enum CompareOp { OP_GT, OP_GE, OP_LT, OP_LE, OP_EQ, OP_NE };
+
+struct Query {
+    QueryKind kind = QUERY_SUMMARY;
+    Field field = FIELD_SOC;
+    CompareOp op = OP_GT;
+    double threshold = 0.0;
+    int64_t bucket_ms = 60000;
+    int64_t from_ms = INT64_MIN;
+    int64_t to_ms = INT64_MAX;
+
+    bool matches(double value) const {
+        switch (op) {
+            case OP_GT: return value > threshold;
+            case OP_GE: return value >= threshold;
+            case OP_LT: return value < threshold;
+            case OP_LE: return value <= threshold;
+            case OP_EQ: return value == threshold;
+            case OP_NE: return value != threshold;
+        }
+        return false;
+    }
+};
+
+// ---- Per-chunk results (merged in time order) ----
+
+struct Totals {
+    uint64_t bms = 0;
+    uint64_t automotive = 0;
+    double distance_km = 0.0;
+    double driving_s = 0.0;
+    double used_wh = 0.0;       // Discharge
+    double charged_wh = 0.0;    // Regen and charging
+
+    void add(const Totals& other) {
+        bms += other.bms;
+        automotive += other.automotive;
+        distance_km += other.distance_km;
+        driving_s += other.driving_s;
+        used_wh += other.used_wh;
+        charged_wh += other.charged_wh;
+    }
+};
+
+struct Bucket {
+    double min = INFINITY;
+    double max = -INFINITY;
+    double sum = 0.0;
+    uint64_t count = 0;
+
+    void add(double value) {
+        min = std::min(min, value);
+        max = std::max(max, value);
+        sum += value;
+        count++;
+    }
+    void add(const Bucket& other) {
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+        sum += other.sum;
+        count += other.count;
+    }
+};
+
+struct Segment {
+    int64_t start_ms;
+    int64_t end_ms;
+    Bucket values;
+};
+
+struct ChunkResult {
+    bool corrupt = false;
+    uint64_t records = 0;
+    int64_t first_time = INT64_MAX;
+    int64_t last_time = INT64_MIN;
+
+    // Boundary samples for integrating across chunks
+    bool has_bms = false;
+    bool has_automotive = false;
+    TelemetrySample first_bms, last_bms, first_automotive, last_automotive;
+
+    std::map<int64_t, Totals> totals;      // Key 0, or local day for energy-per-day
+    std::map<int64_t, Bucket> buckets;     // downsample
+    std::vector<Segment> segments;         // where
+    bool field_seen = false;
+    bool starts_matching = false;
+    bool ends_matching = false;
+    std::string csv;                       // export
+};
+
+// ---- Time helpers ----
+
+// localtime_r takes a global lock - cache the current day per thread
+struct DayCache {
+    int64_t start_ms = 0;
+    int64_t end_ms = -1;
+    int64_t key = 0;
+
+    int64_t dayKey(int64_t time_ms) {
+        if (time_ms >= start_ms && time_ms < end_ms) return key;
+
+        time_t seconds = time_ms / 1000;
+        struct tm local;
+        localtime_r(&seconds, &local);
+        key = (local.tm_year + 1900) * 10000 + (local.tm_mon + 1) * 100 + local.tm_mday;
+        local.tm_hour = local.tm_min = local.tm_sec = 0;
+        local.tm_isdst = -1;
+        start_ms = (int64_t)mktime(&local) * 1000;
+        local.tm_mday += 1;
+        local.tm_isdst = -1;
+        end_ms = (int64_t)mktime(&local) * 1000;
+        return key;
+    }
+};
+
+static std::string formatTime(int64_t time_ms) {
+    time_t seconds = time_ms / 1000;
+    struct tm local;
+    localtime_r(&seconds, &local);
+    char text[40];
+    size_t n = strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &local);
+    snprintf(text + n, sizeof(text) - n, ".%03d", (int)(time_ms % 1000));
+    return text;
+}
+
+// Unix seconds, YYYY-MM-DD or YYYY-MM-DDTHH:MM[:SS] (local time)
+static bool parseTime(const char* text, int64_t& time_ms) {
+    char* end;
+    long long seconds = strtoll(text, &end, 10);
+    if (*end == '\0') {
+        time_ms = seconds * 1000;
+        return true;
+    }
+
+    struct tm local = {};
+    const char* rest = strptime(text, "%Y-%m-%d", &local);
+    if (!rest) return false;
+    if (*rest == 'T' || *rest == ' ') {
+        rest = strptime(rest + 1, "%H:%M", &local);
+        if (rest && *rest == ':') rest = strptime(rest + 1, "%S", &local);
+        if (!rest) return false;
+    }
+    if (*rest != '\0') return false;
+    local.tm_isdst = -1;
+    time_ms = (int64_t)mktime(&local) * 1000;
+    return true;
+}
+
+// ---- Chunk processing ----
+
+// Contribution of the interval between two consecutive samples of one type
+static void integrate(const TelemetrySample& previous, const TelemetrySample& current, Totals& totals) {
+    int64_t dt = current.time_ms - previous.time_ms;
+    if (dt <= 0 || dt > MAX_GAP_MS) return;
+    double hours = dt / 3600000.0;
+
+    if (current.type == TELEMETRY_AUTOMOTIVE) {
+        totals.distance_km += previous.automotive.speed_kmh * hours;
+        if (previous.automotive.speed_kmh > 0.0f) {
+            totals.driving_s += dt / 1000.0;
+        }
+    } else if (previous.bms.dataValid) {
+        // Negative current is discharge
+        double wh = previous.bms.totalVoltage * previous.bms.current * hours;
+        if (wh < 0.0) {
+            totals.used_wh -= wh;
+        } else {
+            totals.charged_wh += wh;
+        }
+    }
+}
+
+static void appendCsv(std::string& out, const TelemetrySample& sample) {
+    char line[256];
+    int n;
+    if (sample.type == TELEMETRY_BMS) {
+        const bms_data_t& bms = sample.bms;
+        n = snprintf(line, sizeof(line), "%lld,bms,%.2f,%.2f,%.1f,%.3f,%.3f,%.1f,%.1f,%d,,,\n",
+                     (long long)sample.time_ms, bms.current, bms.totalVoltage, bms.soc,
+                     bms.minVoltage, bms.maxVoltage, bms.minTemp, bms.maxTemp, bms.dataValid ? 1 : 0);
+    } else {
+        const automotive_data_t& automotive = sample.automotive;
+        const char* gear = automotive.reverse ? "R" : (automotive.forward ? "D" : "N");
+        n = snprintf(line, sizeof(line), "%lld,automotive,,,,,,,,,%.1f,%u,%s\n",
+                     (long long)sample.time_ms, automotive.speed_kmh, (unsigned)automotive.rpm, gear);
+    }
+    out.append(line, n);
+}
+
+class ChunkProcessor {
+public:
+    ChunkProcessor(const Query& query, ChunkResult& result) : query(query), result(result) {}
+
+    void add(const TelemetrySample& sample) {
+        if (sample.time_ms < query.from_ms || sample.time_ms > query.to_ms) return;
+
+        result.records++;
+        result.first_time = std::min(result.first_time, sample.time_ms);
+        result.last_time = std::max(result.last_time, sample.time_ms);
+
+        if (query.kind == QUERY_SUMMARY || query.kind == QUERY_ENERGY_PER_DAY) {
+            int64_t key = query.kind == QUERY_ENERGY_PER_DAY ? days.dayKey(sample.time_ms) : 0;
+            Totals& totals = result.totals[key];
+            if (sample.type == TELEMETRY_BMS) {
+                totals.bms++;
+                if (result.has_bms) integrate(result.last_bms, sample, totals);
+            } else {
+                totals.automotive++;
+                if (result.has_automotive) integrate(result.last_automotive, sample, totals);
+            }
+        }
+
+        if (sample.type == TELEMETRY_BMS) {
+            if (!result.has_bms) result.first_bms = sample;
+            result.last_bms = sample;
+            result.has_bms = true;
+        } else {
+            if (!result.has_automotive) result.first_automotive = sample;
+            result.last_automotive = sample;
+            result.has_automotive = true;
+        }
+
+        double value;
+        switch (query.kind) {
+            case QUERY_DOWNSAMPLE:
+                if (fieldValue(sample, query.field, value)) {
+                    int64_t bucket = sample.time_ms - ((sample.time_ms % query.bucket_ms) + query.bucket_ms) % query.bucket_ms;
+                    result.buckets[bucket].add(value);
+                }
+                break;
+            case QUERY_WHERE:
+                if (fieldValue(sample, query.field, value)) addWhere(sample.time_ms, value);
+                break;
+            case QUERY_EXPORT:
+                appendCsv(result.csv, sample);
+                break;
+            default:
+                break;
+        }
+    }
+
+private:
+    void addWhere(int64_t time_ms, double value) {
+        bool matching = query.matches(value);
+        if (!result.field_seen) {
+            result.starts_matching = matching;
+            result.field_seen = true;
+        }
+
+        if (matching) {
+            bool extend = result.ends_matching && !result.segments.empty() &&
+                          time_ms - result.segments.back().end_ms <= MAX_GAP_MS;
+            if (!extend) {
+                result.segments.push_back(Segment{time_ms, time_ms, Bucket()});
+            }
+            result.segments.back().end_ms = time_ms;
+            result.segments.back().values.add(value);
+        }
+        result.ends_matching = matching;
+    }
+
+    const Query& query;
+    ChunkResult& result;
+    DayCache days;
+};
+
+// ---- Inputs ----
+
+struct InputFile {
+    std::string path;
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    bool telemetry = false;     // .tzl, otherwise a raw serial capture
+    int64_t created_ms = 0;
+};
+
+struct WorkItem {
+    const InputFile* file;
+    TelemetryChunkHeader header;   // Telemetry chunk (unused for raw captures)
+    const uint8_t* payload;
+};
+
+static bool hasSuffix(const std::string& name, const char* suffix) {
+    size_t n = strlen(suffix);
+    return name.size() >= n && name.compare(name.size() - n, n, suffix) == 0;
+}
+
+static void collectPaths(const std::string& path, std::vector<std::string>& out) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        fprintf(stderr, "tazzari-log: %s: %s\n", path.c_str(), strerror(errno));
+        return;
+    }
+    if (!S_ISDIR(st.st_mode)) {
+        out.push_back(path);
+        return;
+    }
+
+    DIR* dir = opendir(path.c_str());
+    if (!dir) return;
+    while (struct dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name == "." || name == "..") continue;
+        std::string child = path + "/" + name;
+        if (hasSuffix(name, ".tzl") || hasSuffix(name, ".bin")) {
+            out.push_back(child);
+        } else if (entry->d_type == DT_DIR) {
+            collectPaths(child, out);
+        }
+    }
+    closedir(dir);
+}
+
+static bool mapFile(const std::string& path, InputFile& file) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        fprintf(stderr, "tazzari-log: %s: %s\n", path.c_str(), strerror(errno));
+        return false;
+    }
+    struct stat st;
+    fstat(fd, &st);
+    file.path = path;
+    file.size = st.st_size;
+    if (file.size > 0) {
+        void* mapped = mmap(nullptr, file.size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            fprintf(stderr, "tazzari-log: %s: mmap: %s\n", path.c_str(), strerror(errno));
+            close(fd);
+            return false;
+        }
+        madvise(mapped, file.size, MADV_WILLNEED);
+        file.data = (const uint8_t*)mapped;
+    }
+    close(fd);
+
+    TelemetryFileHeader header;
+    if (file.size >= sizeof(header)) {
+        memcpy(&header, file.data, sizeof(header));
+        file.telemetry = header.magic == TELEMETRY_FILE_MAGIC;
+        file.created_ms = header.created_ms;
+    }
+    return true;
+}
+
+// Chunk list from the .idx sidecar when it is consistent with the log,
+// otherwise by walking the chunk headers
+static void planChunks(const InputFile& file, const Query& query, std::vector<WorkItem>& items) {
+    auto wanted = [&](const TelemetryChunkHeader& header) {
+        return header.last_time_ms >= query.from_ms && header.first_time_ms <= query.to_ms;
+    };
+
+    std::vector<TelemetryIndexEntry> index;
+    int fd = open((file.path + ".idx").c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        struct stat st;
+        fstat(fd, &st);
+        index.resize(st.st_size / sizeof(TelemetryIndexEntry));
+        if (read(fd, index.data(), index.size() * sizeof(TelemetryIndexEntry)) !=
+            (ssize_t)(index.size() * sizeof(TelemetryIndexEntry))) {
+            index.clear();
+        }
+        close(fd);
+    }
+
+    std::vector<WorkItem> planned;
+    bool index_ok = !index.empty();
+    for (const TelemetryIndexEntry& entry : index) {
+        TelemetryChunkHeader header;
+        if (entry.offset + sizeof(header) > file.size) { index_ok = false; break; }
+        memcpy(&header, file.data + entry.offset, sizeof(header));
+        if (header.magic != TELEMETRY_CHUNK_MAGIC ||
+            header.payload_size > file.size - entry.offset - sizeof(header)) {
+            index_ok = false;
+            break;
+        }
+        if (wanted(header)) {
+            planned.push_back(WorkItem{&file, header, file.data + entry.offset + sizeof(header)});
+        }
+    }
+
+    if (!index_ok) {
+        planned.clear();
+        bool header_ok = TelemetryReader::forEachChunk(file.data, file.size,
+            [&](const TelemetryChunkHeader& header, const uint8_t* payload, size_t) {
+                if (wanted(header)) planned.push_back(WorkItem{&file, header, payload});
+                return true;
+            }, false);
+        if (!header_ok) {
+            fprintf(stderr, "tazzari-log: %s: bad file header\n", file.path.c_str());
+        }
+    }
+    items.insert(items.end(), planned.begin(), planned.end());
+}
+
+static void processItem(const WorkItem& item, const Query& query, ChunkResult& result) {
+    ChunkProcessor processor(query, result);
+
+    if (item.file->telemetry) {
+        if (!TelemetryReader::verifyChunk(item.header, item.payload) ||
+            !TelemetryReader::decodeChunk(item.header, item.payload,
+                [&](const TelemetrySample& sample) { processor.add(sample); })) {
+            result.corrupt = true;
+        }
+        return;
+    }
+
+    // Raw capture - no receive clock, so the ESP32 timestamp is the time base
+    PacketDecoder decoder;
+    TelemetrySample sample;
+    decoder.setPacketCallback([&](uint8_t type, const uint8_t* payload, uint8_t length) {
+        if (type == BMS_PACKET_TYPE && PacketDecoder::decodeBMS(payload, length, sample.bms)) {
+            sample.type = TELEMETRY_BMS;
+            sample.time_ms = sample.bms.timestamp;
+        } else if (type == AUTO_PACKET_TYPE && PacketDecoder::decodeAutomotive(payload, length, sample.automotive)) {
+            sample.type = TELEMETRY_AUTOMOTIVE;
+            sample.time_ms = sample.automotive.timestamp;
+        } else {
+            return;
+        }
+        processor.add(sample);
+    });
+    decoder.feed(item.file->data, item.file->size);
+}
+
+// ---- Merge and output ----
+
+class Merger {
+public:
+    Merger(const Query& query, FILE* out) : query(query), out(out) {
+        if (query.kind == QUERY_EXPORT) {
+            fprintf(out, "time_ms,type,current,voltage,soc,min_cell,max_cell,min_temp,max_temp,valid,speed,rpm,gear\n");
+        }
+    }
+
+    void merge(ChunkResult& chunk) {
+        if (chunk.corrupt) corrupt_chunks++;
+        if (chunk.records == 0) return;
+
+        records += chunk.records;
+        first_time = std::min(first_time, chunk.first_time);
+        last_time = std::max(last_time, chunk.last_time);
+
+        if (query.kind == QUERY_SUMMARY || query.kind == QUERY_ENERGY_PER_DAY) {
+            // The interval spanning the chunk boundary
+            if (acc.has_bms && chunk.has_bms) {
+                integrate(acc.last_bms, chunk.first_bms, acc.totals[totalsKey(chunk.first_bms)]);
+            }
+            if (acc.has_automotive && chunk.has_automotive) {
+                integrate(acc.last_automotive, chunk.first_automotive, acc.totals[totalsKey(chunk.first_automotive)]);
+            }
+            for (auto& entry : chunk.totals) acc.totals[entry.first].add(entry.second);
+        }
+
+        for (auto& entry : chunk.buckets) acc.buckets[entry.first].add(entry.second);
+
+        if (query.kind == QUERY_WHERE && chunk.field_seen) {
+            size_t first = 0;
+            if (acc.ends_matching && chunk.starts_matching && !acc.segments.empty() && !chunk.segments.empty() &&
+                chunk.segments.front().start_ms - acc.segments.back().end_ms <= MAX_GAP_MS) {
+                acc.segments.back().end_ms = chunk.segments.front().end_ms;
+                acc.segments.back().values.add(chunk.segments.front().values);
+                first = 1;
+            }
+            acc.segments.insert(acc.segments.end(), chunk.segments.begin() + first, chunk.segments.end());
+            acc.ends_matching = chunk.ends_matching;
+        }
+
+        if (!chunk.csv.empty()) {
+            fwrite(chunk.csv.data(), 1, chunk.csv.size(), out);
+        }
+
+        if (chunk.has_bms) {
+            acc.last_bms = chunk.last_bms;
+            acc.has_bms = true;
+        }
+        if (chunk.has_automotive) {
+            acc.last_automotive = chunk.last_automotive;
+            acc.has_automotive = true;
+        }
+    }
+
+    void finish(size_t files) {
+        switch (query.kind) {
+            case QUERY_SUMMARY: printSummary(files); break;
+            case QUERY_ENERGY_PER_DAY: printEnergyPerDay(); break;
+            case QUERY_DOWNSAMPLE: printDownsample(); break;
+            case QUERY_WHERE: printSegments(); break;
+            case QUERY_EXPORT: break;
+        }
+        if (corrupt_chunks > 0) {
+            fprintf(stderr, "tazzari-log: %llu corrupt chunks skipped\n", (unsigned long long)corrupt_chunks);
+        }
+    }
+
+    uint64_t getRecords() const { return records; }
+
+private:
+    int64_t totalsKey(const TelemetrySample& sample) {
+        return query.kind == QUERY_ENERGY_PER_DAY ? days.dayKey(sample.time_ms) : 0;
+    }
+
+    void printSummary(size_t files) {
+        Totals& totals = acc.totals[0];
+        fprintf(out, "files        %zu\n", files);
+        fprintf(out, "records      %llu (bms %llu, automotive %llu)\n", (unsigned long long)records,
+                (unsigned long long)totals.bms, (unsigned long long)totals.automotive);
+        if (records == 0) return;
+        fprintf(out, "span         %s - %s\n", formatTime(first_time).c_str(), formatTime(last_time).c_str());
+        fprintf(out, "driving      %.2f h\n", totals.driving_s / 3600.0);
+        fprintf(out, "distance     %.2f km\n", totals.distance_km);
+        fprintf(out, "energy       %.0f Wh used, %.0f Wh regen/charged\n", totals.used_wh, totals.charged_wh);
+        if (totals.distance_km > 0.0) {
+            fprintf(out, "consumption  %.1f Wh/km\n", totals.used_wh / totals.distance_km);
+        }
+    }
+
+    void printEnergyPerDay() {
+        fprintf(out, "day,distance_km,driving_h,used_wh,charged_wh,wh_per_km\n");
+        for (auto& entry : acc.totals) {
+            const Totals& totals = entry.second;
+            int64_t day = entry.first;
+            fprintf(out, "%04lld-%02lld-%02lld,%.3f,%.3f,%.1f,%.1f,", (long long)(day / 10000),
+                    (long long)(day / 100 % 100), (long long)(day % 100),
+                    totals.distance_km, totals.driving_s / 3600.0, totals.used_wh, totals.charged_wh);
+            if (totals.distance_km > 0.0) {
+                fprintf(out, "%.1f", totals.used_wh / totals.distance_km);
+            }
+            fprintf(out, "\n");
+        }
+    }
+
+    void printDownsample() {
+        fprintf(out, "time,time_ms,%s_min,%s_mean,%s_max,samples\n",
+                FIELD_NAMES[query.field], FIELD_NAMES[query.field], FIELD_NAMES[query.field]);
+        for (auto& entry : acc.buckets) {
+            const Bucket& bucket = entry.second;
+            fprintf(out, "%s,%lld,%.4g,%.4g,%.4g,%llu\n", formatTime(entry.first).c_str(), (long long)entry.first,
+                    bucket.min, bucket.sum / bucket.count, bucket.max, (unsigned long long)bucket.count);
+        }
+    }
+
+    void printSegments() {
+        fprintf(out, "start,end,duration_s,%s_min,%s_max,samples\n", FIELD_NAMES[query.field], FIELD_NAMES[query.field]);
+        for (const Segment& segment : acc.segments) {
+            fprintf(out, "%s,%s,%.3f,%.4g,%.4g,%llu\n", formatTime(segment.start_ms).c_str(),
+                    formatTime(segment.end_ms).c_str(), (segment.end_ms - segment.start_ms) / 1000.0,
+                    segment.values.min, segment.values.max, (unsigned long long)segment.values.count);
+        }
+    }
+
+    const Query& query;
+    FILE* out;
+    ChunkResult acc;
+    DayCache days;
+    uint64_t records = 0;
+    uint64_t corrupt_chunks = 0;
+    int64_t first_time = INT64_MAX;
+    int64_t last_time = INT64_MIN;
+};
+
+// Workers decode items in any order; the main thread merges them strictly
+// in order. Workers stay at most `window` items ahead so export output is
+// streamed instead of held in memory.
+static uint64_t runParallel(const std::vector<WorkItem>& items, const Query& query, Merger& merger, int threads) {
+    size_t window = threads * 4;
+    std::vector<std::unique_ptr<ChunkResult>> results(items.size());
+    std::vector<char> done(items.size(), 0);
+    std::mutex mutex;
+    std::condition_variable result_ready;
+    std::condition_variable window_open;
+    size_t next_item = 0;
+    size_t merged = 0;
+
+    auto worker = [&] {
+        while (true) {
+            size_t index;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                window_open.wait(lock, [&] { return next_item >= items.size() || next_item < merged + window; });
+                if (next_item >= items.size()) return;
+                index = next_item++;
+            }
+
+            auto result = std::make_unique<ChunkResult>();
+            processItem(items[index], query, *result);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                results[index] = std::move(result);
+                done[index] = 1;
+            }
+            result_ready.notify_one();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back(worker);
+    }
+
+    for (size_t i = 0; i < items.size(); i++) {
+        std::unique_ptr<ChunkResult> result;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            result_ready.wait(lock, [&] { return done[i] != 0; });
+            result = std::move(results[i]);
+            merged = i + 1;
+        }
+        window_open.notify_all();
+        merger.merge(*result);
+    }
+
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+    return merger.getRecords();
+}
+
+// ---- Command line ----
+
+static void usage() {
+    fprintf(stderr,
+        "usage: tazzari-log [options] <query> <files or directories...>\n"
+        "\n"
+        "queries:\n"
+        "  summary                      records, time span, distance and energy\n"
+        "  where <field> <op> <value>   segments where the condition holds (CSV)\n"
+        "                               op: > >= < <= == !=\n"
+        "  energy-per-day               distance, energy and Wh/km per local day (CSV)\n"
+        "  downsample <field> <secs>    min/mean/max per time bucket (CSV)\n"
+        "  export                       every sample (CSV)\n"
+        "\n"
+        "fields: soc current voltage power_kw min_cell max_cell cell_delta min_temp max_temp speed rpm\n"
+        "\n"
+        "options:\n"
+        "  -j <threads>   worker threads (default: all cores)\n"
+        "  --from <time>  --to <time>   Unix seconds, YYYY-MM-DD or YYYY-MM-DDTHH:MM[:SS]\n"
+        "  -o <file>      write to file instead of stdout\n"
+        "\n"
+        "Directories are searched for .tzl logs and .bin raw serial captures.\n"
+        "Raw captures use the ESP32 timestamp (ms since its boot) as time.\n");
+}
+
+static bool parseOp(const char* text, CompareOp& op) {
+    static const struct { const char* text; CompareOp op; } ops[] = {
+        {">", OP_GT}, {">=", OP_GE}, {"<", OP_LT}, {"<=", OP_LE}, {"==", OP_EQ}, {"!=", OP_NE},
+    };
+    for (const auto& entry : ops) {
+        if (strcmp(text, entry.text) == 0) {
+            op = entry.op;
+            return true;
+        }
+    }
+    return false;
+}
+
+int main(int argc, char** argv) {
+    Query query;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    const char* output_path = nullptr;
+    std::vector<std::string> args;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "-j" && has_value) {
+            threads = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--from" && has_value) {
+            if (!parseTime(argv[++i], query.from_ms)) { usage(); return 2; }
+        } else if (arg == "--to" && has_value) {
+            if (!parseTime(argv[++i], query.to_ms)) { usage(); return 2; }
+        } else if (arg == "-o" && has_value) {
+            output_path = argv[++i];
+        } else if (arg == "-h" || arg == "--help") {
+            usage();
+            return 0;
+        } else {
+            args.push_back(arg);
+        }
+    }
+    if (args.empty()) {
+        usage();
+        return 2;
+    }
+
+    size_t next = 1;
+    const std::string& command = args[0];
+    if (command == "summary") {
+        query.kind = QUERY_SUMMARY;
+    } else if (command == "energy-per-day") {
+        query.kind = QUERY_ENERGY_PER_DAY;
+    } else if (command == "export") {
+        query.kind = QUERY_EXPORT;
+    } else if (command == "where" && args.size() >= 4) {
+        query.kind = QUERY_WHERE;
+        if (!parseField(args[1].c_str(), query.field) || !parseOp(args[2].c_str(), query.op)) {
+            usage();
+            return 2;
+        }
+        query.threshold = atof(args[3].c_str());
+        next = 4;
+    } else if (command == "downsample" && args.size() >= 3) {
+        query.kind = QUERY_DOWNSAMPLE;
+        if (!parseField(args[1].c_str(), query.field) || atof(args[2].c_str()) <= 0.0) {
+            usage();
+            return 2;
+        }
+        query.bucket_ms = (int64_t)(atof(args[2].c_str()) * 1000.0);
+        next = 3;
+    } else {
+        usage();
+        return 2;
+    }
+
+    std::vector<std::string> paths;
+    for (size_t i = next; i < args.size(); i++) {
+        collectPaths(args[i], paths);
+    }
+    if (paths.empty()) {
+        fprintf(stderr, "tazzari-log: no input files\n");
+        return 1;
+    }
+
+    auto started = std::chrono::steady_clock::now();
+
+    std::vector<InputFile> files;
+    files.reserve(paths.size());
+    for (const std::string& path : paths) {
+        InputFile file;
+        if (mapFile(path, file)) files.push_back(file);
+    }
+
+    // Time order: telemetry logs by creation time, raw captures after them
+    std::stable_sort(files.begin(), files.end(), [](const InputFile& a, const InputFile& b) {
+        if (a.telemetry != b.telemetry) return a.telemetry;
+        return a.created_ms < b.created_ms;
+    });
+
+    std::vector<WorkItem> items;
+    for (const InputFile& file : files) {
+        if (file.telemetry) {
+            planChunks(file, query, items);
+        } else if (file.size > 0) {
+            items.push_back(WorkItem{&file, TelemetryChunkHeader(), nullptr});
+        }
+    }
+
+    FILE* out = stdout;
+    if (output_path) {
+        out = fopen(output_path, "w");
+        if (!out) {
+            fprintf(stderr, "tazzari-log: %s: %s\n", output_path, strerror(errno));
+            return 1;
+        }
+    }
+
+    Merger merger(query, out);
+    uint64_t records = runParallel(items, query, merger, threads);
+    merger.finish(files.size());
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    fprintf(stderr, "tazzari-log: %zu files, %zu chunks, %llu records in %.2fs (%d threads)\n",
+            files.size(), items.size(), (unsigned long long)records, seconds, threads);
+
+    if (out != stdout) fclose(out);
+    for (const InputFile& file : files) {
+        if (file.data) munmap((void*)file.data, file.size);
+    }
+    return 0;
+}